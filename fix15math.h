@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 16-bit fixed-point computation (Q15)
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * Kernels for signals which only need 16 bits, such that twice as many
+ * elements fit into a SIMD register (or a 32-bit word) than with the 32-bit
+ * functions.  The array functions are written branch-free with 32-bit
+ * intermediate results, such that compilers can vectorize them (e.g., the
+ * multiplication maps to 'pmulhrsw' on x86 with SSSE3 or AVX2); the scalar
+ * functions use the same code and produce bit-identical results.
+ *
+ * Unlike 'fix32_mul()', the Q15 multiplication rounds half up, which is what
+ * SIMD instruction sets commonly implement.  This header may be included any
+ * number of times.
+ */
+#ifndef FIX15MATH_H
+#define FIX15MATH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Multiply two Q15 numbers (i.e., with a scaling factor of 2^15) with the
+ * product rounded half up, like the 'pmulhrsw' instruction: the result is
+ * (a * b + 2^14) >> 15 , where -1 * -1 wraps around to -1.
+ */
+static int16_t fix15_mul(int16_t a, int16_t b)
+{
+    // this form of rounding is recognized by vectorizing compilers
+    return (int16_t)(((((int32_t)a * b) >> 14) + 1) >> 1);
+}
+
+
+/**
+ * Element-wise multiplication of the 'count' Q15 elements of the arrays 'a'
+ * and 'b' with 'fix15_mul()'; 'res' may be identical to 'a' or 'b'.
+ */
+void fix15_mul_array(const int16_t *a, const int16_t *b, int16_t *res,
+                     size_t count);
+
+
+/**
+ * Dot product of the 'count' elements of the 16-bit arrays 'a' and 'b',
+ * scaled down by 2^n (with 1 <= n <= 63) and rounded half up.  The products
+ * are accumulated in 64 bits; the result is 32 bits wide, which allows e.g.
+ * a Q15 dot product (n = 15) to exceed the range of Q15.
+ */
+int32_t fix15_dot(const int16_t *a, const int16_t *b, size_t count, int n);
+
+
+/**
+ * Approximate the inverse square root of a 16-bit fixed point value with a
+ * scaling factor of 2^scale.  Undefined for val <= 0.
+ *
+ * A cubic approximation is refined with two iterations of Newton's method;
+ * the relative error is in the order of 2^-13.
+ *
+ * @param val   16-bit fixed point input value with scaling factor 2^scale
+ * @param scale scaling factor power; input and output parameter
+ * @return      16-bit fixed point inverse square root of val with a scaling
+ *              factor of 2^scale, where scale has been modified in order to
+ *              retain high precision (the result is between 2^13 and 2^14)
+ */
+int16_t fix15_invsqrt(int16_t val, int *scale);
+
+/**
+ * Inverse square root of the 'count' elements of 'src' with a scaling factor
+ * of 2^scale, written to 'dst' with a common scaling factor of 2^res_scale;
+ * results which do not fit into 16 bits saturate.  Undefined for elements
+ * <= 0.
+ */
+void fix15_invsqrt_array(const int16_t *src, int16_t *dst, size_t count,
+                         int scale, int res_scale);
+
+
+/**
+ * Approximate atan2, i.e. the arcus tangens of y/x , of two 16-bit fixed point
+ * coordinates with the same (arbitrary) scaling factor.  The absolute error is
+ * about 2^-13; returns 0 for x = y = 0.
+ *
+ * @return  arcus tangens of y/x in radians with a scaling factor of 2^13
+ */
+int16_t fix15_atan2(int16_t y, int16_t x);
+
+/**
+ * Element-wise atan2 of the 'count' elements of the arrays 'y' and 'x' (see
+ * 'fix15_atan2()').
+ */
+void fix15_atan2_array(const int16_t *y, const int16_t *x, int16_t *res,
+                       size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX15MATH_H
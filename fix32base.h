@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 32-bit fixed-point computation: basic definitions
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * This header contains everything that does not depend on the macros
+ * controlling the rounding and overflow actions of 'fix32_mul()' (see
+ * 'fix32math.h'), i.e. the scale functions, functions with explicitly named
+ * rounding and overflow policy and the declarations of the library functions.
+ * Unlike 'fix32math.h', it may be included any number of times and from
+ * header files.
+ */
+#ifndef FIX32BASE_H
+#define FIX32BASE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// The static helpers below are also usable in constant expressions when
+// compiled as C++14 or later (see 'fix32constexpr.hpp').
+#if defined(__cplusplus) && __cplusplus >= 201402L
+#define FIX32_CONSTEXPR constexpr
+#else
+#define FIX32_CONSTEXPR
+#endif
+
+
+/**
+ * Scale down a signed 32-bit or 64-bit fixed point number (equivalent to a
+ * division by 2^n) with rounding to nearest in following flavours (see
+ * https://en.wikipedia.org/wiki/Rounding#Rounding_to_the_nearest_integer ):
+ *
+ *  - RHU: Round Half Up (i.e. 0.5 becomes 1 and -0.5 becomes 0),
+ *    by adding 2^(n-1) to val before shifting.
+ *
+ *  - RHD: Round Half Down (i.e. 0.5 becomes 0 and -0.5 becomes -1),
+ *    by adding 2^(n-1) - 1 to val before shifting.
+ *
+ *  - RHAZ: Round Half Away from Zero (i.e. 0.5 becomes 1 and -0.5 becomes -1),
+ *    by adding 2^(n-1) if val is positive and 2^(n-1) - 1 if val is negative.
+ *
+ *  - RHTZ: Round Half Towards Zero (i.e. 0.5 becomes 0 and -0.5 becomes 0),
+ *    by adding 2^(n-1) - 1 if val is positive and 2^(n-1) if val is negative.
+ */
+// scale function template; allows to specify integer data type, function name
+// extension and what else to add to val besides 2^(n-1) before shifting:
+#define FIX32_MATH_SCALE_FUNCTION(DTYPE, NAME_SUFFIX, ADD_TO_VAL_BESIDE_HALF) \
+static FIX32_CONSTEXPR DTYPE fix32_scale_##NAME_SUFFIX (DTYPE val, int n) {   \
+    return (val + ((1LL << (n - 1)) ADD_TO_VAL_BESIDE_HALF)) >> n;            \
+}
+FIX32_MATH_SCALE_FUNCTION(int32_t, rhu_32, )                    // 32-bit RHU
+FIX32_MATH_SCALE_FUNCTION(int32_t, rhd_32, - 1)                 // 32-bit RHD
+FIX32_MATH_SCALE_FUNCTION(int32_t, rhaz_32, + (val >> 31))      // 32-bit RHAZ
+FIX32_MATH_SCALE_FUNCTION(int32_t, rhtz_32, + (~(val >> 31)))   // 32-bit RHTZ
+FIX32_MATH_SCALE_FUNCTION(int64_t, rhu_64, )                    // 64-bit RHU
+FIX32_MATH_SCALE_FUNCTION(int64_t, rhd_64, - 1)                 // 64-bit RHD
+FIX32_MATH_SCALE_FUNCTION(int64_t, rhaz_64, + (val >> 63))      // 64-bit RHAZ
+FIX32_MATH_SCALE_FUNCTION(int64_t, rhtz_64, + (~(val >> 63)))   // 64-bit RHTZ
+
+
+/**
+ * Rounding flavours of the 'fix32_scale_*()' group, for interfaces which
+ * select the rounding with a parameter.
+ */
+typedef enum fix32_rounding {
+    FIX32_RHU,      // Round Half Up
+    FIX32_RHD,      // Round Half Down
+    FIX32_RHAZ,     // Round Half Away from Zero
+    FIX32_RHTZ      // Round Half Towards Zero
+} fix32_rounding;
+
+
+/**
+ * Multiply-accumulate: add the full 64-bit product of 'a' and 'b' to the
+ * 64-bit accumulator 'acc' without any rounding.  Products of fixed point
+ * numbers with scaling factor 2^n have a scaling factor of 2^(2n); use
+ * 'fix32_acc_scale(acc, n)' to obtain the final 32-bit result.
+ */
+static FIX32_CONSTEXPR int64_t fix32_mac(int64_t acc, int32_t a, int32_t b)
+{
+    return acc + (int64_t)a * b;
+}
+
+
+/**
+ * Saturating arithmetic: results which do not fit into 32 bits are clamped to
+ * the largest or smallest 32-bit value (INT32_MAX or INT32_MIN) instead of
+ * wrapping around.  All variants are branch-free (the clamping is a select
+ * operation); addition and subtraction only use 32-bit operations.
+ *
+ *  - fix32_sat_64():       clamp a 64-bit value to 32 bits
+ *  - fix32_add_sat():      a + b
+ *  - fix32_sub_sat():      a - b
+ *
+ * See 'fix32math.h' for saturating multiplication.
+ */
+static FIX32_CONSTEXPR int32_t fix32_sat_64(int64_t val)
+{
+    // (val >> 63) ^ INT32_MAX is INT32_MAX for positive and INT32_MIN for
+    // negative values (when truncated to 32 bits)
+    return (val == (int32_t)val) ? (int32_t)val
+                                 : (int32_t)((val >> 63) ^ INT32_MAX);
+}
+
+static FIX32_CONSTEXPR int32_t fix32_add_sat(int32_t a, int32_t b)
+{
+    int32_t sum = (uint32_t)a + (uint32_t)b;
+    // overflow occurred if the sign of the sum differs from both operands
+    return ((a ^ sum) & (b ^ sum)) < 0 ? (a >> 31) ^ INT32_MAX : sum;
+}
+
+static FIX32_CONSTEXPR int32_t fix32_sub_sat(int32_t a, int32_t b)
+{
+    int32_t diff = (uint32_t)a - (uint32_t)b;
+    // overflow occurred if the operands have different signs and the sign of
+    // the difference differs from the minuend
+    return ((a ^ b) & (a ^ diff)) < 0 ? (a >> 31) ^ INT32_MAX : diff;
+}
+
+
+/**
+ * Multiplication with explicitly named rounding and overflow policy, which is
+ * independent of the macros FIX32_MATH_MUL_ROUND_FUNC and
+ * FIX32_MATH_MUL_OVERFLOW_ACTION and can thus be chosen per call site:
+ *
+ *  - fix32_acc_scale_<rounding>(acc, n):     round a 64-bit accumulator
+ *  - fix32_acc_scale_<rounding>_sat(acc, n): ... with saturation
+ *  - fix32_mul_<rounding>(a, b, n):          multiply
+ *  - fix32_mul_<rounding>_sat(a, b, n):      ... with saturation
+ *
+ * where <rounding> is one of rhu, rhd, rhaz or rhtz (see above).  Overflow
+ * wraps around silently in the variants without saturation.
+ */
+// template for the functions of one rounding flavour:
+#define FIX32_MATH_MUL_FUNCTIONS(ROUNDING)                                    \
+static FIX32_CONSTEXPR int32_t                                                \
+fix32_acc_scale_##ROUNDING (int64_t acc, int n) {                             \
+    return fix32_scale_##ROUNDING##_64(acc, n);                               \
+}                                                                             \
+static FIX32_CONSTEXPR int32_t                                                \
+fix32_acc_scale_##ROUNDING##_sat (int64_t acc, int n) {                       \
+    return fix32_sat_64(fix32_scale_##ROUNDING##_64(acc, n));                 \
+}                                                                             \
+static FIX32_CONSTEXPR int32_t                                                \
+fix32_mul_##ROUNDING (int32_t a, int32_t b, int n) {                          \
+    return fix32_scale_##ROUNDING##_64((int64_t)a * b, n);                    \
+}                                                                             \
+static FIX32_CONSTEXPR int32_t                                                \
+fix32_mul_##ROUNDING##_sat (int32_t a, int32_t b, int n) {                    \
+    return fix32_sat_64(fix32_scale_##ROUNDING##_64((int64_t)a * b, n));      \
+}
+FIX32_MATH_MUL_FUNCTIONS(rhu)
+FIX32_MATH_MUL_FUNCTIONS(rhd)
+FIX32_MATH_MUL_FUNCTIONS(rhaz)
+FIX32_MATH_MUL_FUNCTIONS(rhtz)
+
+
+#define FIX32_INVSQRT_NEWTON_ITERS    2
+
+/**
+ * Inverse square root core shared by 'fix32_invsqrt()' and the batch kernels
+ * in 'fix32batch.h': approximate 1/sqrt(a) for an already normalized value
+ * 1 <= a < 4 with a scaling factor of 2^30.  The result 0.5 < res <= 1 also
+ * has a scaling factor of 2^30.
+ */
+static inline FIX32_CONSTEXPR uint32_t fix32_invsqrt_norm(uint32_t a)
+{
+    // 1/sqrt(a) is approximated by cubic interpolation in order to get
+    // smooth transitions between interpolation intervals.
+    // Since 1 <= a < 4 we interpolate in the interval [1,4].
+    // The derivative of 1/sqrt(a) is: d/da 1/sqrt(a) = -1/(2 a sqrt(a)),
+    // therefore these are the boundary conditions:
+    // 1/sqrt(1) = 1, 1/sqrt(4) = 0.5,
+    // d/da 1/sqrt(a=1) = -0.5, d/da 1/sqrt(a=4) = -0.0625
+    // which yields following cubic polynomial:
+    // p(a) = -11/432 a^3 + 19/72 a^2 - 137/144 a + 185/108
+
+    // Polynomial constant fractions
+    const uint32_t frac_11_432  = 0x684BDA13, //  11 / 432 with scaling 2^36
+                   frac_19_72   = 0x871C71C7, //  19 / 72  with scaling 2^33
+                   frac_137_144 = 0x3CE38E39, // 137 / 144 with scaling 2^30
+                   frac_185_108 = 0x0DB425ED; // 185 / 108 with scaling 2^27
+
+    // Calculate a^2 and a^3; use scaling factor of 2^27 and 2^24 respectively,
+    // to accomodate for larger ranges (i.e., 1 <= a^2 < 16 and 1 <= a^3 < 64 )
+    // and require calculating the upper 32-bit word only (despite rounding)
+    uint32_t a_squ = ((uint64_t)a * a     + (1uLL<<32)) >> 33, // scale 2^27
+             a_cub = ((uint64_t)a * a_squ + (1uLL<<32)) >> 33; // scale 2^24
+
+    // Do additions before subtractions and use a scaling factor of 2^27 for
+    // intermediate results to avoid overflow of unsigned integers and require
+    // calculating the upper 32-bit word only for 64-bit multiplications
+    uint32_t res = (((          frac_185_108
+        + (uint32_t)(((uint64_t)frac_19_72   * a_squ + (1uLL<<32)) >> 33) )
+        - (uint32_t)(((uint64_t)frac_137_144 * a     + (1uLL<<32)) >> 33) )
+        - (uint32_t)(((uint64_t)frac_11_432  * a_cub + (1uLL<<32)) >> 33) );
+
+    // 0.5 < res <= 1 ; scale res up to a scaling factor of 2^30 (we could use
+    // 2^31, but it should be possible to cast the final res to a signed 32-bit
+    // integer without issues, thus we use 2^30 to keep the sign bit clear)
+    res <<= 3;
+
+#ifdef FIX32_INVSQRT_NEWTON_ITERS
+    // Now let us refine this with Newton's method
+
+    const uint32_t _1p5 = 3u<<24; // 1.5 with a scaling factor of 2^25
+    int i = 0;
+    for (; i < FIX32_INVSQRT_NEWTON_ITERS; i++) {
+        // 0.25 < res^2 <= 1 ; store res^2 with a scaling factor of 2^28 to
+        // avoid calculating the lower 32-bit multiplication result
+        uint32_t res_squ = ((uint64_t)res * res + (1uLL<<32)) >> 33;
+
+        // Since 1 <= a < 4 , 0.125 <= a * res^2 / 2 < 2 ; use a scaling factor
+        // of 2^25 for the result to avoid calculating the lower 32-bit result
+        // of the 64-bit multiplication (note that 'a' has a scaling factor of
+        // 2^30; also, the result of the multiplication is divided by 2)
+        uint32_t half_a_res_squ = ((uint64_t)a * res_squ + (1uLL<<32)) >> 33;
+
+        // For a > 2, res < 0.8 , thus res^2 < 0.75 , hence a * res^2 / 2 < 1.5
+        // therefore 1.5 - a * res^2 / 2 is always positive; 'res' should
+        // retain its scaling factor of 2^30
+        res = ((uint64_t)res * (_1p5 - half_a_res_squ) + (1uLL<<24)) >> 25;
+    }
+#endif
+
+    return res;
+}
+
+
+/**
+ * Saturating element-wise addition, subtraction and multiplication of the
+ * 'count' elements of the arrays 'a' and 'b'; 'res' may be identical to 'a'
+ * or 'b'.
+ */
+void fix32_add_sat_array(const int32_t *a, const int32_t *b, int32_t *res,
+                         size_t count);
+void fix32_sub_sat_array(const int32_t *a, const int32_t *b, int32_t *res,
+                         size_t count);
+void fix32_mul_sat_array(const int32_t *a, const int32_t *b, int32_t *res,
+                         size_t count, int n);
+
+
+/**
+ * Dot product of the 'count' elements of the arrays 'a' and 'b' with scaling
+ * factor 2^n, i.e. the sum of a[i] * b[i] scaled down by 2^n.
+ *
+ * The products are accumulated in 64 bits and rounded once at the end with
+ * 'fix32_acc_scale()'.  The accumulator cannot overflow for fewer than
+ * 2^(63 - 2m) elements whose magnitude does not exceed 2^m.
+ * 'fix32_dot_wide()' instead accumulates in 96 bits, which allows up to 2^31
+ * elements of arbitrary magnitude at the cost of a few additional additions
+ * per element.
+ *
+ * The strided variant reads every 'stride_a'-th element of 'a' and every
+ * 'stride_b'-th element of 'b' (e.g., a column of a row-major matrix).
+ */
+int32_t fix32_dot(const int32_t *a, const int32_t *b, size_t count, int n);
+int32_t fix32_dot_strided(const int32_t *a, ptrdiff_t stride_a,
+                          const int32_t *b, ptrdiff_t stride_b,
+                          size_t count, int n);
+int32_t fix32_dot_wide(const int32_t *a, const int32_t *b, size_t count,
+                       int n);
+
+
+/**
+ * Linkage of 'fix32_invsqrt()', 'fix32_recip()', 'fix32_atan2()' and
+ * 'fix32_sincos()': if the macro FIX32MATH_INLINE is defined (consistently for
+ * all translation units, e.g. with -DFIX32MATH_INLINE), these functions are
+ * defined 'static inline' by 'fix32math.h' rather than linked from the
+ * library, such that they can be inlined and specialized for constant scaling
+ * factors.  Any translation unit calling them must then include 'fix32math.h'.
+ */
+#ifdef FIX32MATH_INLINE
+#define FIX32_MATH_IMPL static inline
+#else
+#define FIX32_MATH_IMPL
+#endif
+
+
+/**
+ * Approximate the inverse square root of a 32-bit fixed point value with a
+ * scaling factor of 2^scale.  Undefined for val = 0.
+ *
+ * The approximation is calculated using cubic interpolation and improved with
+ * one or two iterations of Newton's method (see FIX32_INVSQRT_NEWTON_ITERS).
+ * The relative error is less than 1 % with one iteration and less than 0.01 %
+ * with two iterations.  The result is well-conditioned and smooth with
+ * continuous first derivative.
+ *
+ * @param val   32-bit fixed point input value with scaling factor 2^scale
+ * @param scale scaling factor power; input and output parameter
+ * @return      32-bit fixed point inverse square root of val with a scaling
+ *              factor of 2^scale, where scale has been modified in order to
+ *              retain high precision; the result can safely be cast to signed.
+ */
+FIX32_MATH_IMPL uint32_t fix32_invsqrt(uint32_t val, int *scale);
+
+/**
+ * Inverse square root of the 'count' elements of 'src' with a scaling factor
+ * of 2^scale, written to 'dst' with the common scaling factor 2^res_scale in
+ * a single pass (i.e., without per-element scales).  Results which do not fit
+ * into a signed 32-bit integer (including those of elements equal to 0)
+ * saturate to INT32_MAX.
+ *
+ * The '_auto' variant chooses the largest res_scale for which no result
+ * saturates, determined from the smallest non-zero element in a preceding
+ * pass, and returns it; the largest result is then between 2^29 and 2^30.
+ */
+void fix32_invsqrt_array(const uint32_t *src, int32_t *dst, size_t count,
+                         int scale, int res_scale);
+int fix32_invsqrt_array_auto(const uint32_t *src, int32_t *dst, size_t count,
+                             int scale);
+
+
+/**
+ * Approximate the reciprocal of a 32-bit fixed point value with a scaling
+ * factor of 2^scale.  Undefined for val = 0.
+ *
+ * The reciprocal is obtained by squaring the result of fix32_invsqrt and
+ * refined with one iteration of Newton's method, such that the relative error
+ * is less than 2^-24.
+ *
+ * @param val   32-bit fixed point input value with scaling factor 2^scale
+ * @param scale scaling factor power; input and output parameter
+ * @return      32-bit fixed point reciprocal of val with a scaling factor of
+ *              2^scale, where scale has been modified in order to retain high
+ *              precision; the magnitude of the result is about 2^30 at most.
+ */
+FIX32_MATH_IMPL int32_t fix32_recip(int32_t val, int *scale);
+
+
+/**
+ * Rough approximation of atan2, i.e. the arcus tangens of y/x .  The absolute
+ * error is below 0.0051 (about 0.3 degrees, at most on the diagonals) for any
+ * input format, since x and y are normalized internally; returns 0 for
+ * x = y = 0.
+ *
+ * The 'scale' argument is deprecated and ignored: since the normalization
+ * makes every intermediate result independent of the input format, versions
+ * specialized per scale would perform the same operations (see the atan2
+ * benchmark of 'make bench').  It is retained for source compatibility.
+ *
+ * @param y, x  32-bit fixed point input coordinates (of the same scale)
+ * @param scale deprecated, ignored (formerly the scaling factor power of 2 of
+ *              x and y)
+ * @return      32-bit fixed point arcus tangens of y/x with a scaling factor
+ *              of 2^28
+ */
+FIX32_MATH_IMPL int32_t fix32_atan2(int32_t y, int32_t x, int scale);
+
+
+/**
+ * Approximate sine and cosine of an angle.
+ *
+ * The angle is reduced to the interval [-pi/4, pi/4] and sine and cosine are
+ * approximated with Taylor polynomials.  The absolute error is in the order of
+ * 2^-29.
+ *
+ * @param angle    32-bit fixed point angle in radians with a scaling factor of
+ *                 2^28 (i.e., the output format of fix32_atan2)
+ * @param sin_val  output for the sine of angle with a scaling factor of 2^30
+ * @param cos_val  output for the cosine of angle with a scaling factor of 2^30
+ */
+FIX32_MATH_IMPL void fix32_sincos(int32_t angle, int32_t *sin_val,
+                                 int32_t *cos_val);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32BASE_H
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Auto-vectorizable batch kernels for libfix32math
+ *
+ * Portable reference versions of 'fix32_mul()', 'fix32_invsqrt()' and
+ * 'fix32_atan2()' for arrays, written such that compilers can vectorize them
+ * without hand-written intrinsics: the loops are annotated with
+ * '#pragma omp simd' (effective when compiling with '-fopenmp-simd' and
+ * FIX32_OPENMP_SIMD defined, i.e. 'make OPENMP_SIMD=1', or with OpenMP),
+ * the arrays are 'restrict'-qualified and hence must not overlap, the loop
+ * bodies are free of branches and function calls, and per-element scaling
+ * factors are returned in a separate array instead of through an 'int *'
+ * argument of each call.  The results are bit-identical to those of the
+ * scalar functions.  'make check-vectorize' verifies that the compiler
+ * vectorizes all loops.
+ */
+
+#ifndef FIX32BATCH_H
+#define FIX32BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+#define FIX32_RESTRICT __restrict
+extern "C" {
+#else
+#define FIX32_RESTRICT restrict
+#endif
+
+
+/**
+ * Products res[i] = a[i] * b[i] / 2^n, rounded with the rounding function
+ * selected for 'fix32_mul()' (overflow is ignored).
+ */
+void fix32_batch_mul(const int32_t *FIX32_RESTRICT a,
+                     const int32_t *FIX32_RESTRICT b,
+                     int32_t *FIX32_RESTRICT res, size_t count, int n);
+
+/**
+ * Inverse square roots of the elements of 'src' with a scaling factor of
+ * 2^scale; the result for src[i] is dst[i] with a scaling factor of
+ * 2^res_scale[i], as returned by 'fix32_invsqrt()'.  The results for
+ * elements equal to 0 are unspecified.
+ */
+void fix32_batch_invsqrt(const uint32_t *FIX32_RESTRICT src,
+                         int32_t *FIX32_RESTRICT dst,
+                         int32_t *FIX32_RESTRICT res_scale, size_t count,
+                         int scale);
+
+/**
+ * Arcus tangens of y[i]/x[i] with a scaling factor of 2^28, as returned by
+ * 'fix32_atan2()' (the result does not depend on the common scaling factor
+ * of x and y); 0 for x[i] = y[i] = 0.
+ */
+void fix32_batch_atan2(const int32_t *FIX32_RESTRICT y,
+                       const int32_t *FIX32_RESTRICT x,
+                       int32_t *FIX32_RESTRICT res, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32BATCH_H
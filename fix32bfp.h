@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Block floating point arrays for libfix32math
+ *
+ * A block holds 'count' 32-bit mantissas which share a single scaling factor
+ * of 2^scale, i.e. element i has the value mant[i] / 2^scale.  The operations
+ * choose the scaling factor of their result block such that no element
+ * overflows and the largest magnitude retains as many bits as possible;
+ * hence no per-element exponents or overflow checks are required.
+ *
+ * A normalized block has exactly one redundant sign bit (guard bit), i.e. its
+ * largest magnitude is at least 2^29 and at most 2^30, such that the sum of
+ * two normalized blocks with the same scale cannot overflow.  The results of
+ * all operations are normalized.
+ *
+ * The mantissa arrays are provided by the caller.  All blocks passed to an
+ * operation must have the same number of elements; the result block may be
+ * identical to an operand.
+ */
+
+#ifndef FIX32BFP_H
+#define FIX32BFP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct fix32_bfp {
+    int32_t *mant;  // mantissas
+    size_t count;   // number of elements
+    int scale;      // shared scaling factor power of the mantissas
+} fix32_bfp;
+
+
+/**
+ * Initialize a block with the 'count' mantissas in 'mant' and the scaling
+ * factor 2^scale (the mantissas are neither copied nor normalized).
+ */
+void fix32_bfp_init(fix32_bfp *bfp, int32_t *mant, size_t count, int scale);
+
+/**
+ * Number of bits by which all mantissas of a block can be shifted left
+ * without overflow (i.e., the number of redundant sign bits of the largest
+ * magnitude); 31 if all mantissas are 0 or -1.
+ */
+int fix32_bfp_headroom(const fix32_bfp *bfp);
+
+/**
+ * Normalize a block, i.e. shift its mantissas and adjust its scale such that
+ * the headroom is 1; blocks whose mantissas are all 0 remain unchanged.
+ * Renormalizes blocks which have been modified element-wise as well.
+ */
+void fix32_bfp_normalize(fix32_bfp *bfp);
+
+/**
+ * Element-wise multiplication and addition of blocks 'a' and 'b'.
+ */
+void fix32_bfp_mul(const fix32_bfp *a, const fix32_bfp *b, fix32_bfp *res);
+void fix32_bfp_add(const fix32_bfp *a, const fix32_bfp *b, fix32_bfp *res);
+
+/**
+ * Element-wise inverse square root and square root of a block (see
+ * 'fix32_invsqrt()'); the elements must be positive (or non-negative in case
+ * of the square root).
+ */
+void fix32_bfp_invsqrt(const fix32_bfp *src, fix32_bfp *res);
+void fix32_bfp_sqrt(const fix32_bfp *src, fix32_bfp *res);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32BFP_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Biquad IIR filter cascade for libfix32math
+ *
+ * Each section of the cascade computes
+ *
+ *     y[k] = b0 x[k] + b1 x[k-1] + b2 x[k-2] - a1 y[k-1] - a2 y[k-2]
+ *
+ * with coefficients with a scaling factor of 2^n (n = 30 allows coefficients
+ * in the interval [-2, 2), which covers a1 of stable sections).  The sum of
+ * products is accumulated in 64 bits and rounded once per output sample with
+ * the rounding flavour chosen per filter at run time (one of the
+ * 'fix32_scale_*()' group, see 'fix32base.h'); overflow of the output sample
+ * wraps around.
+ *
+ * Two structures are available:
+ *
+ *  - Direct Form I, optionally with first-order error feedback (the rounding
+ *    error of each output sample is added to the accumulator of the next
+ *    one), which shapes the quantization noise away from DC and suppresses
+ *    limit cycles at the cost of one addition and one subtraction per sample.
+ *
+ *  - Direct Form II transposed with 64-bit state variables, i.e. the only
+ *    rounding is that of the output sample.
+ *
+ * Blocks are processed section by section, keeping the state of a section in
+ * local variables while it filters the whole block.
+ */
+
+#ifndef FIX32BIQUAD_H
+#define FIX32BIQUAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fix32base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct fix32_biquad_coeffs {
+    int32_t b0, b1, b2, a1, a2;
+} fix32_biquad_coeffs;
+
+typedef struct fix32_biquad_state {
+    int32_t x1, x2, y1, y2; // Direct Form I: past input and output samples
+    int64_t err;            // Direct Form I: rounding error feedback
+    int64_t s1, s2;         // Direct Form II transposed: state variables
+} fix32_biquad_state;
+
+typedef enum fix32_biquad_form {
+    FIX32_BIQUAD_DF1,       // Direct Form I
+    FIX32_BIQUAD_DF1_EF,    // Direct Form I with error feedback
+    FIX32_BIQUAD_DF2T       // Direct Form II transposed
+} fix32_biquad_form;
+
+typedef struct fix32_biquad {
+    const fix32_biquad_coeffs *coeffs;  // coefficients of each section
+    fix32_biquad_state *state;          // state of each section
+    size_t sections;                    // number of sections
+    fix32_biquad_form form;             // filter structure
+    fix32_rounding rounding;            // rounding of the output samples
+    int n;                              // scaling factor power of coeffs
+} fix32_biquad;
+
+
+/**
+ * Initialize a cascade of 'sections' biquad sections and clear its state.  The
+ * coefficients are not copied; 'state' must provide space for 'sections'
+ * elements.  Both arrays must remain valid while the filter is in use.
+ * 'rounding' selects the rounding flavour of the output samples.
+ */
+void fix32_biquad_init(fix32_biquad *bq, const fix32_biquad_coeffs *coeffs,
+                       fix32_biquad_state *state, size_t sections,
+                       fix32_biquad_form form, fix32_rounding rounding,
+                       int n);
+
+/**
+ * Clear the state of all sections of a biquad cascade.
+ */
+void fix32_biquad_reset(fix32_biquad *bq);
+
+/**
+ * Filter a block of 'count' samples with the cascade; 'in' and 'out' may be
+ * identical.  A cascade of 0 sections copies 'in' to 'out'.
+ */
+void fix32_biquad_process(fix32_biquad *bq, const int32_t *in, int32_t *out,
+                          size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32BIQUAD_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Complex number math for libfix32math
+ *
+ * Complex numbers are stored as pairs of signed 32-bit fixed point values
+ * (real part first), hence arrays of complex numbers match the layout of
+ * interleaved I/Q buffers.  Each real and imaginary part of a product is
+ * accumulated in 64 bits and rounded once with the rounding function and
+ * overflow action selected for 'fix32_mul()'.
+ */
+
+#ifndef FIX32CMPLX_H
+#define FIX32CMPLX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct fix32_cmplx {
+    int32_t re, im;
+} fix32_cmplx;
+
+
+/**
+ * Complex product a * b of two complex numbers with scaling factor 2^n.
+ */
+fix32_cmplx fix32_cmplx_mul(fix32_cmplx a, fix32_cmplx b, int n);
+
+/**
+ * Complex product a * b using 3 instead of 4 multiplications (Gauss' trick),
+ * at the cost of 3 additional additions; the multiplications have a 33-bit
+ * operand, thus the magnitude of all parts should be below 2^30.  Only
+ * beneficial if multiplications are considerably slower than additions.
+ */
+fix32_cmplx fix32_cmplx_mul_gauss(fix32_cmplx a, fix32_cmplx b, int n);
+
+/**
+ * Complex product a * conj(b) of two complex numbers with scaling factor 2^n.
+ */
+fix32_cmplx fix32_cmplx_mul_conj(fix32_cmplx a, fix32_cmplx b, int n);
+
+/**
+ * Magnitude |a|, with the same scaling factor as a, computed with
+ * 'fix32_invsqrt()'; the magnitude must be below 2^31.
+ */
+int32_t fix32_cmplx_mag(fix32_cmplx a);
+
+/**
+ * Phase arg(a) with a scaling factor of 2^28, computed with 'fix32_atan2()'
+ * (which scales the real and imaginary part to full precision); the phase of
+ * 0 is 0.
+ */
+int32_t fix32_cmplx_phase(fix32_cmplx a);
+
+
+/**
+ * Batched variants operating on arrays of 'count' complex numbers; the output
+ * array may be identical to an input array.
+ */
+void fix32_cmplx_mul_array(const fix32_cmplx *a, const fix32_cmplx *b,
+                           fix32_cmplx *res, size_t count, int n);
+void fix32_cmplx_mul_conj_array(const fix32_cmplx *a, const fix32_cmplx *b,
+                                fix32_cmplx *res, size_t count, int n);
+void fix32_cmplx_mag_array(const fix32_cmplx *a, int32_t *mag, size_t count);
+void fix32_cmplx_phase_array(const fix32_cmplx *a, int32_t *phase,
+                             size_t count);
+
+
+
+/**
+ * Streaming phase-difference (FM discriminator) kernel: computes the phase of
+ * s[i] * conj(s[i-1]) for a stream of complex samples s (of arbitrary scale)
+ * with a scaling factor of 2^28, i.e. the phase difference of consecutive
+ * samples in the interval [-pi, pi].  The conjugate product is kept in full
+ * 64-bit precision and scaled to the optimal range of 'fix32_atan2()' without
+ * intermediate rounding.  The last sample of a block is retained in the state
+ * and used as predecessor of the first sample of the next block; the
+ * predecessor of the very first sample is 0, yielding a phase difference of 0.
+ */
+typedef struct fix32_cmplx_disc {
+    fix32_cmplx prev;   // last sample of the previous block
+} fix32_cmplx_disc;
+
+void fix32_cmplx_disc_init(fix32_cmplx_disc *disc);
+void fix32_cmplx_disc_process(fix32_cmplx_disc *disc, const fix32_cmplx *in,
+                              int32_t *out, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32CMPLX_H
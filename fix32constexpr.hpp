@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 32-bit fixed-point computation: compile-time evaluation
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * This header provides 'constexpr' variants of the library functions in the
+ * namespace 'fix32::cx', such that lookup tables can be computed by the
+ * compiler and placed in read-only memory instead of being filled at startup:
+ *
+ *     struct table { int32_t val[256]; };
+ *     constexpr table make_table()
+ *     {
+ *         table t = {};
+ *         for (int i = 1; i < 256; i++) {
+ *             fix32::cx::invsqrt_result r = fix32::cx::invsqrt(i, 0);
+ *             t.val[i] = fix32::cx::scale_rhaz_64(r.val, r.scale - 24);
+ *         }
+ *         return t;
+ *     }
+ *     constexpr table tab = make_table();
+ *
+ * The functions are instantiated from the same sources as the library (the
+ * helpers of 'fix32base.h' and the implementation in 'fix32math_impl.h'), so
+ * the results are bit-identical with the library built with the default
+ * configuration (i.e., RHAZ rounding for 'fix32_mul()' and two Newton
+ * iterations for 'fix32_invsqrt()').  Functions with output parameters
+ * return a struct instead.  Requires C++14 (relaxed constexpr); inputs for
+ * which the library functions are undefined fail to compile in constant
+ * expressions.
+ */
+#ifndef FIX32CONSTEXPR_HPP
+#define FIX32CONSTEXPR_HPP
+
+#include "fix32base.h"
+
+#if __cplusplus < 201402L
+#error "ERROR: `fix32constexpr.hpp' requires C++14"
+#endif
+
+namespace fix32 {
+namespace cx {
+
+namespace detail {
+#define FIX32_MATH_IMPL_CONSTEXPR
+#include "fix32math_impl.h"
+#undef FIX32_MATH_IMPL_CONSTEXPR
+} // namespace detail
+
+
+/**
+ * Scale functions (see 'fix32_scale_*()').
+ */
+constexpr int32_t scale_rhu_32(int32_t val, int n)
+{
+    return fix32_scale_rhu_32(val, n);
+}
+constexpr int32_t scale_rhd_32(int32_t val, int n)
+{
+    return fix32_scale_rhd_32(val, n);
+}
+constexpr int32_t scale_rhaz_32(int32_t val, int n)
+{
+    return fix32_scale_rhaz_32(val, n);
+}
+constexpr int32_t scale_rhtz_32(int32_t val, int n)
+{
+    return fix32_scale_rhtz_32(val, n);
+}
+constexpr int64_t scale_rhu_64(int64_t val, int n)
+{
+    return fix32_scale_rhu_64(val, n);
+}
+constexpr int64_t scale_rhd_64(int64_t val, int n)
+{
+    return fix32_scale_rhd_64(val, n);
+}
+constexpr int64_t scale_rhaz_64(int64_t val, int n)
+{
+    return fix32_scale_rhaz_64(val, n);
+}
+constexpr int64_t scale_rhtz_64(int64_t val, int n)
+{
+    return fix32_scale_rhtz_64(val, n);
+}
+
+/**
+ * 64-bit scale function selected by a rounding flavour.
+ */
+constexpr int64_t scale_64(int64_t val, int n, fix32_rounding r)
+{
+    return (r == FIX32_RHU)  ? fix32_scale_rhu_64(val, n) :
+           (r == FIX32_RHD)  ? fix32_scale_rhd_64(val, n) :
+           (r == FIX32_RHAZ) ? fix32_scale_rhaz_64(val, n) :
+                               fix32_scale_rhtz_64(val, n);
+}
+
+
+/**
+ * Multiplication and saturating arithmetic (see 'fix32_mac()',
+ * 'fix32_acc_scale()', 'fix32_mul()', 'fix32_sat_64()', etc.); the rounding
+ * defaults to RHAZ and overflow wraps around unless saturated.
+ */
+constexpr int64_t mac(int64_t acc, int32_t a, int32_t b)
+{
+    return fix32_mac(acc, a, b);
+}
+
+constexpr int32_t acc_scale(int64_t acc, int n,
+                            fix32_rounding r = FIX32_RHAZ)
+{
+    return (int32_t)scale_64(acc, n, r);
+}
+
+constexpr int32_t mul(int32_t a, int32_t b, int n,
+                      fix32_rounding r = FIX32_RHAZ)
+{
+    return acc_scale((int64_t)a * b, n, r);
+}
+
+constexpr int32_t sat_64(int64_t val)
+{
+    return fix32_sat_64(val);
+}
+
+constexpr int32_t add_sat(int32_t a, int32_t b)
+{
+    return fix32_add_sat(a, b);
+}
+
+constexpr int32_t sub_sat(int32_t a, int32_t b)
+{
+    return fix32_sub_sat(a, b);
+}
+
+constexpr int32_t mul_sat(int32_t a, int32_t b, int n,
+                          fix32_rounding r = FIX32_RHAZ)
+{
+    return fix32_sat_64(scale_64((int64_t)a * b, n, r));
+}
+
+
+/**
+ * Result of 'invsqrt()' and 'recip()': the value and its scaling factor power
+ * (i.e., the value of '*scale' after calling the library function).
+ */
+struct invsqrt_result {
+    uint32_t val;
+    int scale;
+};
+
+struct recip_result {
+    int32_t val;
+    int scale;
+};
+
+/**
+ * Inverse square root (see 'fix32_invsqrt()').
+ */
+constexpr invsqrt_result invsqrt(uint32_t val, int scale)
+{
+    uint32_t res = detail::fix32_invsqrt(val, &scale);
+    return invsqrt_result{res, scale};
+}
+
+/**
+ * Reciprocal (see 'fix32_recip()').
+ */
+constexpr recip_result recip(int32_t val, int scale)
+{
+    int32_t res = detail::fix32_recip(val, &scale);
+    return recip_result{res, scale};
+}
+
+
+/**
+ * Approximation of atan2 with a scaling factor of 2^28 (see
+ * 'fix32_atan2()').
+ */
+constexpr int32_t atan2(int32_t y, int32_t x, int scale)
+{
+    return detail::fix32_atan2(y, x, scale);
+}
+
+
+/**
+ * Result of 'sincos()' with a scaling factor of 2^30.
+ */
+struct sincos_result {
+    int32_t sin_val;
+    int32_t cos_val;
+};
+
+/**
+ * Sine and cosine of an angle in radians with a scaling factor of 2^28 (see
+ * 'fix32_sincos()').
+ */
+constexpr sincos_result sincos(int32_t angle)
+{
+    sincos_result res = {0, 0};
+    detail::fix32_sincos(angle, &res.sin_val, &res.cos_val);
+    return res;
+}
+
+
+/**
+ * Conversion between radians with a scaling factor of 2^28 and turns with a
+ * scaling factor of 2^32 (see 'fix32_rad_to_turn()' in 'fix32nco.h').
+ */
+constexpr uint32_t rad_to_turn(int32_t rad)
+{
+    const int64_t _8_pi = 0xA2F9836E;
+    return (uint32_t)fix32_scale_rhaz_64(rad * _8_pi, 30);
+}
+
+constexpr int32_t turn_to_rad(uint32_t turn)
+{
+    const int64_t pi_8 = 0x6487ED51;
+    return (int32_t)fix32_scale_rhaz_64((int32_t)turn * pi_8, 32);
+}
+
+
+} // namespace cx
+} // namespace fix32
+
+#endif // FIX32CONSTEXPR_HPP
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Conversion between floating point and fixed point arrays for libfix32math
+ *
+ * Floating point values are converted to 32-bit fixed point numbers with a
+ * scaling factor of 2^scale with the rounding flavours of the
+ * 'fix32_scale_*()' group (see 'fix32base.h'), i.e. the result is exactly the
+ * value times 2^scale rounded to the nearest integer (no double rounding),
+ * and saturation to INT32_MIN or INT32_MAX for values out of range; NaN is
+ * converted to 0.  The conversion to floating point is exact for double and
+ * rounds to nearest (even) for float.
+ *
+ * The loops are branch-free, such that compilers can vectorize them; on
+ * targets without FPU the floating point operations are emulated in software.
+ * The scaling factor power 'scale' must be within [-1022, 1023].
+ */
+
+#ifndef FIX32CONV_H
+#define FIX32CONV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fix32base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Convert the 'count' elements of 'src' to fixed point numbers with a
+ * scaling factor of 2^scale, rounded as specified by 'rounding'.
+ */
+void fix32_from_float(const float *src, int32_t *dst, size_t count, int scale,
+                      fix32_rounding rounding);
+void fix32_from_double(const double *src, int32_t *dst, size_t count,
+                       int scale, fix32_rounding rounding);
+
+/**
+ * Convert the 'count' fixed point numbers with a scaling factor of 2^scale in
+ * 'src' to floating point.
+ */
+void fix32_to_float(const int32_t *src, float *dst, size_t count, int scale);
+void fix32_to_double(const int32_t *src, double *dst, size_t count,
+                     int scale);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32CONV_H
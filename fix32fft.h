@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Fixed-point FFT for libfix32math
+ *
+ * In-place radix-2 decimation-in-time FFT of 2^log2n complex 32-bit samples,
+ * stored either interleaved (real and imaginary parts alternating) or in
+ * separate arrays of real and imaginary parts.
+ *
+ * The twiddle factors are read from a quarter-wave sine table with a scaling
+ * factor of 2^30, which is generated at build time (see tools/gensintab.c);
+ * the largest supported transform size is 2^FIX32_SINTAB_BITS (set with the
+ * make variable of the same name, 4096 by default).  Each butterfly is
+ * computed in 64 bits and rounded once per output with the rounding function
+ * selected for 'fix32_mul()'.
+ *
+ * Overflow is avoided with block floating point: before each stage, the data
+ * is scaled down by 2 or 4 (within the butterflies, thus without an additional
+ * rounding step) if any value might overflow during that stage.  The number
+ * of such halvings is returned as block exponent, i.e. the actual spectrum is
+ * the output multiplied by 2^exponent.
+ */
+
+#ifndef FIX32FFT_H
+#define FIX32FFT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Forward FFT, X[k] = sum x[j] exp(-2 pi i j k / N), of N = 2^log2n samples
+ * stored interleaved in 'buf' (2 * N values) or split into 're' and 'im'.
+ *
+ * @return  block exponent (see above), or -1 if log2n is not supported
+ */
+int fix32_fft(int32_t *buf, int log2n);
+int fix32_fft_split(int32_t *re, int32_t *im, int log2n);
+
+/**
+ * Inverse FFT without normalization, x[j] = sum X[k] exp(2 pi i j k / N); the
+ * result must be divided by N, i.e. subtract log2n from the block exponent.
+ *
+ * @return  block exponent (see above), or -1 if log2n is not supported
+ */
+int fix32_ifft(int32_t *buf, int log2n);
+int fix32_ifft_split(int32_t *re, int32_t *im, int log2n);
+
+
+/**
+ * Post-processing of 'count' interleaved complex values (e.g., FFT output):
+ * magnitude (with the same scaling factor as the input) and phase (with a
+ * scaling factor of 2^28); see 'fix32_cmplx_mag()' and 'fix32_cmplx_phase()'.
+ */
+void fix32_fft_magnitude(const int32_t *buf, int32_t *mag, size_t count);
+void fix32_fft_phase(const int32_t *buf, int32_t *phase, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32FFT_H
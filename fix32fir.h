@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * FIR filter engine for libfix32math
+ *
+ * The delay line of the filter is double-buffered: each input sample is
+ * written twice, 'taps' samples apart, such that the most recent 'taps'
+ * samples are always available as one contiguous window (newest sample
+ * first) and no samples need to be moved.  Each output sample is computed
+ * with 'fix32_dot()', i.e. accumulated in 64 bits and rounded once with the
+ * rounding function and overflow action selected for 'fix32_mul()'.
+ *
+ * The coefficients have a scaling factor of 2^n and the output samples have
+ * the same scaling factor as the input samples.
+ */
+
+#ifndef FIX32FIR_H
+#define FIX32FIR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct fix32_fir {
+    const int32_t *coeffs;  // 'taps' coefficients with scaling factor 2^n
+    int32_t *delay;         // delay line of 2 * taps samples
+    size_t taps;            // number of coefficients
+    size_t pos;             // index of the newest sample in the delay line
+    size_t phase;           // input samples since the last decimated output
+    int n;                  // scaling factor power of the coefficients
+} fix32_fir;
+
+
+/**
+ * Initialize an FIR filter with 'taps' coefficients and clear its state.  The
+ * coefficients are not copied; 'delay' must provide space for 2 * taps
+ * samples.  Both arrays must remain valid while the filter is in use.
+ *
+ * @return  0 on success, or -1 if taps is 0 (the filter is left untouched)
+ */
+int fix32_fir_init(fix32_fir *fir, const int32_t *coeffs, size_t taps,
+                   int32_t *delay, int n);
+
+/**
+ * Clear the delay line of an FIR filter.
+ */
+void fix32_fir_reset(fix32_fir *fir);
+
+/**
+ * Filter a block of 'count' samples; 'in' and 'out' may be identical.
+ */
+void fix32_fir_process(fix32_fir *fir, const int32_t *in, int32_t *out,
+                       size_t count);
+
+/**
+ * Filter and decimate a block of 'count' samples by 'factor', i.e. compute
+ * only every 'factor'-th output sample.  The decimation phase is retained
+ * across blocks, thus 'count' need not be a multiple of 'factor'.  'in' and
+ * 'out' may be identical.
+ *
+ * @return  number of output samples written to 'out', or 0 if factor is 0
+ *          (the input is then ignored and the filter left untouched)
+ */
+size_t fix32_fir_decimate(fix32_fir *fir, const int32_t *in, int32_t *out,
+                          size_t count, size_t factor);
+
+/**
+ * Interpolate a block of 'count' samples by 'factor' (zero insertion followed
+ * by filtering) using a polyphase decomposition of the filter, which skips
+ * the products with the inserted zeros; writes count * factor samples to
+ * 'out', which must not overlap 'in'.  Scale the coefficients by 'factor' to
+ * retain the signal amplitude.
+ */
+void fix32_fir_interpolate(fix32_fir *fir, const int32_t *in, int32_t *out,
+                           size_t count, size_t factor);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32FIR_H
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 32-bit fixed-point computation: C++ fixed point value type
+ * with a scaling factor known at compile time
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * 'fix32::fixed<IntBits, FracBits, Rounding>' wraps a 32-bit fixed point
+ * number with FracBits fractional bits (i.e., a scaling factor of
+ * 2^FracBits) and IntBits integer bits including the sign bit, such that
+ * IntBits + FracBits = 32.  The scaling factors of all results are derived at
+ * compile time, so that every shift amount is a constant and the generated
+ * code equals that of the corresponding calls to 'fix32_mul_<rounding>()'
+ * with literal shift amounts:
+ *
+ *     typedef fix32::fixed<2, 30> q30;
+ *     typedef fix32::fixed<16, 16> q16;
+ *
+ *     q30 a = q30::from_raw(...), b = ...;
+ *     q16 c = ...;
+ *     fix32::fixed<18, 14> p = a * c;    // full product, rounded once
+ *     a *= b;                            // fix32_mul_rhaz(a, b, 30)
+ *     q16 d = q16(a * c);                // rescaled to 2^16, rounded twice
+ *     q16 e = fix32::mul<q16>(a, c);     // rescaled to 2^16, rounded once
+ *
+ * The product of fixed<I1, F1> and fixed<I2, F2> has type
+ * fixed<I1 + I2, 32 - I1 - I2>, i.e. it keeps the integer bits of both
+ * operands and as many fractional bits as fit.  Results are rounded with the
+ * rounding flavour of the left operand (or of the result type for
+ * conversions and 'fix32::mul<>()'); overflow wraps around silently.
+ *
+ * The library functions with variable scaling factors are available with a
+ * result type chosen by the caller ('invsqrt<>()' and 'recip<>()') or a
+ * fixed result type ('atan2()' and 'sincos()').
+ */
+#ifndef FIX32FIXED_HPP
+#define FIX32FIXED_HPP
+
+#include "fix32math.hpp"
+
+namespace fix32 {
+
+
+namespace detail {
+
+/**
+ * Scale a 64-bit value with a scaling factor of 2^From to a scaling factor of
+ * 2^To, with rounding if bits are lost.  From and To are constants, hence
+ * only one of the branches remains.
+ */
+template <int From, int To, fix32_rounding R>
+inline int64_t rescale(int64_t val)
+{
+    // the dummy shift amounts keep the unused branch well-defined:
+    return (From > To)
+        ? rounding_policy<R>::scale(val, From > To ? From - To : 1)
+        : (int64_t)((uint64_t)val << (From < To ? To - From : 0));
+}
+
+/**
+ * Same for a scaling factor of 2^from only known at run time, as returned by
+ * the library functions with variable output scale.
+ */
+template <int To, fix32_rounding R>
+inline int64_t rescale(int64_t val, int from)
+{
+    // a shift by 63 or more bits results in 0 for any 32-bit value anyway:
+    int shift = from - To;
+    if (shift > 0) {
+        return rounding_policy<R>::scale(val, shift < 63 ? shift : 63);
+    }
+    return (int64_t)((uint64_t)val << (-shift < 63 ? -shift : 63));
+}
+
+} // namespace detail
+
+
+template <int IntBits, int FracBits, fix32_rounding Rounding = FIX32_RHAZ>
+class fixed {
+    static_assert(IntBits >= 1 && FracBits >= 0 && IntBits + FracBits == 32,
+                  "fix32::fixed requires IntBits >= 1 (including the sign bit)"
+                  " and IntBits + FracBits == 32");
+
+public:
+    static const int int_bits = IntBits;
+    static const int frac_bits = FracBits;
+    static const fix32_rounding rounding = Rounding;
+
+    constexpr fixed() : val_(0) {}
+
+    /**
+     * Convert a floating point constant (rounded half away from zero).  This
+     * is intended for compile-time constants; on targets without FPU any
+     * conversion at run time is emulated in software.
+     */
+    explicit constexpr fixed(double v)
+        : val_((int32_t)(v * (double)(1LL << FracBits) + (v < 0 ? -.5 : .5)))
+    {}
+
+    /**
+     * Convert from a fixed point number with a different scaling factor or
+     * rounding flavour, with the rounding flavour of this type.
+     */
+    template <int I2, int F2, fix32_rounding R2>
+    explicit fixed(fixed<I2, F2, R2> other)
+        : val_((int32_t)detail::rescale<F2, FracBits, Rounding>(other.raw()))
+    {}
+
+    static constexpr fixed from_raw(int32_t raw)
+    {
+        return fixed(raw_tag(), raw);
+    }
+
+    static constexpr fixed from_int(int32_t i)
+    {
+        return fixed(raw_tag(), (int32_t)((uint32_t)i << FracBits));
+    }
+
+    constexpr int32_t raw() const { return val_; }
+
+    fixed operator-() const
+    {
+        return from_raw((int32_t)(0u - (uint32_t)val_));
+    }
+
+    fixed &operator+=(fixed rhs)
+    {
+        val_ = fix32::add(val_, rhs.val_);
+        return *this;
+    }
+
+    fixed &operator-=(fixed rhs)
+    {
+        val_ = fix32::sub(val_, rhs.val_);
+        return *this;
+    }
+
+    /**
+     * Multiply in place, keeping the type of the left operand (equivalent to
+     * 'fix32_mul_<rounding>(a, b, F2)').
+     */
+    template <int I2, int F2, fix32_rounding R2>
+    fixed &operator*=(fixed<I2, F2, R2> rhs)
+    {
+        val_ = (int32_t)detail::rescale<FracBits + F2, FracBits, Rounding>(
+            (int64_t)val_ * rhs.raw());
+        return *this;
+    }
+
+private:
+    struct raw_tag {};
+    constexpr fixed(raw_tag, int32_t raw) : val_(raw) {}
+
+    int32_t val_;
+};
+
+
+/**
+ * Addition and subtraction of fixed point numbers of the same type.
+ */
+template <int I, int F, fix32_rounding R>
+inline fixed<I, F, R> operator+(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a += b;
+}
+
+template <int I, int F, fix32_rounding R>
+inline fixed<I, F, R> operator-(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a -= b;
+}
+
+
+/**
+ * Product type of fixed<I1, F1> and fixed<I2, F2>.
+ */
+template <int I1, int F1, int I2, int F2, fix32_rounding R>
+struct product {
+    static_assert(I1 + I2 <= 32, "fix32::fixed product has more than 32 "
+                                 "integer bits; use fix32::mul<>() instead");
+    typedef fixed<I1 + I2, 32 - I1 - I2, R> type;
+};
+
+template <int I1, int F1, fix32_rounding R1,
+          int I2, int F2, fix32_rounding R2>
+inline typename product<I1, F1, I2, F2, R1>::type
+operator*(fixed<I1, F1, R1> a, fixed<I2, F2, R2> b)
+{
+    typedef typename product<I1, F1, I2, F2, R1>::type result;
+    int64_t prod = (int64_t)a.raw() * b.raw();
+    return result::from_raw(
+        (int32_t)detail::rescale<F1 + F2, result::frac_bits, R1>(prod));
+}
+
+
+/**
+ * Multiply two fixed point numbers and round the product once to the type
+ * Result (with the rounding flavour of Result).
+ */
+template <class Result, int I1, int F1, fix32_rounding R1,
+          int I2, int F2, fix32_rounding R2>
+inline Result mul(fixed<I1, F1, R1> a, fixed<I2, F2, R2> b)
+{
+    int64_t prod = (int64_t)a.raw() * b.raw();
+    return Result::from_raw((int32_t)detail::rescale<F1 + F2,
+                                                     Result::frac_bits,
+                                                     Result::rounding>(prod));
+}
+
+
+/**
+ * Comparison of fixed point numbers of the same type.
+ */
+template <int I, int F, fix32_rounding R>
+inline bool operator==(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a.raw() == b.raw();
+}
+
+template <int I, int F, fix32_rounding R>
+inline bool operator!=(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a.raw() != b.raw();
+}
+
+template <int I, int F, fix32_rounding R>
+inline bool operator<(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a.raw() < b.raw();
+}
+
+template <int I, int F, fix32_rounding R>
+inline bool operator>(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a.raw() > b.raw();
+}
+
+template <int I, int F, fix32_rounding R>
+inline bool operator<=(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a.raw() <= b.raw();
+}
+
+template <int I, int F, fix32_rounding R>
+inline bool operator>=(fixed<I, F, R> a, fixed<I, F, R> b)
+{
+    return a.raw() >= b.raw();
+}
+
+
+/**
+ * Inverse square root and reciprocal (see 'fix32_invsqrt()' and
+ * 'fix32_recip()'), converted to the type Result chosen by the caller; the
+ * result wraps around if it does not fit into Result.  Undefined for 0 (and
+ * for negative values in case of the inverse square root).
+ */
+template <class Result, int I, int F, fix32_rounding R>
+inline Result invsqrt(fixed<I, F, R> x)
+{
+    int scale = F;
+    uint32_t res = fix32_invsqrt((uint32_t)x.raw(), &scale);
+    return Result::from_raw(
+        (int32_t)detail::rescale<Result::frac_bits, Result::rounding>(res,
+                                                                      scale));
+}
+
+template <class Result, int I, int F, fix32_rounding R>
+inline Result recip(fixed<I, F, R> x)
+{
+    int scale = F;
+    int32_t res = fix32_recip(x.raw(), &scale);
+    return Result::from_raw(
+        (int32_t)detail::rescale<Result::frac_bits, Result::rounding>(res,
+                                                                      scale));
+}
+
+
+/**
+ * Angles in radians with a scaling factor of 2^28 (the output format of
+ * 'fix32_atan2()' and the input format of 'fix32_sincos()') and sine and
+ * cosine values with a scaling factor of 2^30.
+ */
+typedef fixed<4, 28> angle;
+typedef fixed<2, 30> unit;
+
+template <int I, int F, fix32_rounding R>
+inline angle atan2(fixed<I, F, R> y, fixed<I, F, R> x)
+{
+    return angle::from_raw(fix32_atan2(y.raw(), x.raw(), F));
+}
+
+inline void sincos(angle a, unit &sin_val, unit &cos_val)
+{
+    int32_t s, c;
+    fix32_sincos(a.raw(), &s, &c);
+    sin_val = unit::from_raw(s);
+    cos_val = unit::from_raw(c);
+}
+
+
+} // namespace fix32
+
+#endif // FIX32FIXED_HPP
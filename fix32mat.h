@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Small fixed-size matrix kernels for libfix32math
+ *
+ * Matrices of size 2x2, 3x3 and 4x4 are stored as arrays of signed 32-bit
+ * fixed point values in row-major order.  All elements of a matrix share the
+ * scaling factor 2^n.  Each element of a product is accumulated in 64 bits
+ * and rounded once with the rounding function selected for 'fix32_mul()'.
+ * Output arrays may be identical to input arrays.
+ */
+
+#ifndef FIX32MAT_H
+#define FIX32MAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Matrix product res = a * b of two matrices with scaling factor 2^n.
+ */
+void fix32_mat2_mul(const int32_t a[4], const int32_t b[4], int32_t res[4],
+                    int n);
+void fix32_mat3_mul(const int32_t a[9], const int32_t b[9], int32_t res[9],
+                    int n);
+void fix32_mat4_mul(const int32_t a[16], const int32_t b[16], int32_t res[16],
+                    int n);
+
+/**
+ * Transpose a matrix.
+ */
+void fix32_mat2_transpose(const int32_t a[4], int32_t res[4]);
+void fix32_mat3_transpose(const int32_t a[9], int32_t res[9]);
+void fix32_mat4_transpose(const int32_t a[16], int32_t res[16]);
+
+/**
+ * Invert a matrix with scaling factor 2^n using the adjugate matrix and
+ * 'fix32_recip()' for the reciprocal of the determinant; the inverse has the
+ * same scaling factor 2^n.  Elements should not exceed 2^30 in magnitude.
+ *
+ * @return  0 on success; -1 if the matrix is singular or if an element of the
+ *          inverse (or of the adjugate matrix) does not fit into 32 bits with
+ *          scaling factor 2^n (the content of 'res' is undefined in that case)
+ */
+int fix32_mat2_inverse(const int32_t a[4], int32_t res[4], int n);
+int fix32_mat3_inverse(const int32_t a[9], int32_t res[9], int n);
+
+
+/**
+ * Batch transform of 'count' vectors stored consecutively in 'src' by the
+ * matrix 'm' with scaling factor 2^n, i.e. dst[i] = m * src[i], where the
+ * vectors have 2, 3 or 4 components matching the size of the matrix.
+ */
+void fix32_mat2_transform(const int32_t m[4], const int32_t *src, int32_t *dst,
+                          size_t count, int n);
+void fix32_mat3_transform(const int32_t m[9], const int32_t *src, int32_t *dst,
+                          size_t count, int n);
+void fix32_mat4_transform(const int32_t m[16], const int32_t *src,
+                          int32_t *dst, size_t count, int n);
+
+/**
+ * Batch affine transform of 'count' 3-D points stored consecutively in 'src'
+ * by the 4x4 matrix 'm' with scaling factor 2^n, treating each point as a
+ * homogeneous vector with w = 1; the last row of 'm' is ignored.  The
+ * translation (the last column of 'm') has the same scaling factor as the
+ * points.
+ */
+void fix32_mat4_transform_points(const int32_t m[16], const int32_t *src,
+                                 int32_t *dst, size_t count, int n);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32MAT_H
@@ -35,46 +35,53 @@
  * the source file) to avoid conflicting definitions of the macros controlling
  * the rounding and overflow actions of fixed point arithmetic.  Avoid
  * including it from header files.
+ *
+ * Where the rounding or overflow policy needs to differ between call sites,
+ * use the functions with explicitly named policies from 'fix32base.h' (or the
+ * templates in 'fix32math.hpp' from C++), which has no such restriction.
  */
 #ifdef FIX32MATH_H
 #error "ERROR: `fix32math.h' must not be included more than once"
 #endif
 #define FIX32MATH_H
 
-#include <stdint.h>
+#include "fix32base.h"
 
 
 /**
- * Scale down a signed 32-bit or 64-bit fixed point number (equivalent to a
- * division by 2^n) with rounding to nearest in following flavours (see
- * https://en.wikipedia.org/wiki/Rounding#Rounding_to_the_nearest_integer ):
- *
- *  - RHU: Round Half Up (i.e. 0.5 becomes 1 and -0.5 becomes 0),
- *    by adding 2^(n-1) to val before shifting.
- *
- *  - RHD: Round Half Down (i.e. 0.5 becomes 0 and -0.5 becomes -1),
- *    by adding 2^(n-1) - 1 to val before shifting.
+ * Round a 64-bit sum of products of fixed point numbers to a 32-bit fixed
+ * point number, i.e. scale it down by 2^n with the rounding function and the
+ * overflow action that 'fix32_mul()' uses (see below).
  *
- *  - RHAZ: Round Half Away from Zero (i.e. 0.5 becomes 1 and -0.5 becomes -1),
- *    by adding 2^(n-1) if val is positive and 2^(n-1) - 1 if val is negative.
+ * Together with 'fix32_mac()' this allows to compute a sum of products with a
+ * single final rounding (and overflow check) instead of rounding each product:
  *
- *  - RHTZ: Round Half Towards Zero (i.e. 0.5 becomes 0 and -0.5 becomes 0),
- *    by adding 2^(n-1) - 1 if val is positive and 2^(n-1) if val is negative.
+ *     int64_t acc = 0;
+ *     acc = fix32_mac(acc, a0, b0);
+ *     acc = fix32_mac(acc, a1, b1);
+ *     int32_t res = fix32_acc_scale(acc, n); // (a0 * b0 + a1 * b1) / 2^n
  */
-// scale function template; allows to specify integer data type, function name
-// extension and what else to add to val besides 2^(n-1) before shifting:
-#define FIX32_MATH_SCALE_FUNCTION(DTYPE, NAME_SUFFIX, ADD_TO_VAL_BESIDE_HALF) \
-static DTYPE fix32_scale_##NAME_SUFFIX (DTYPE val, int n) {                   \
-    return (val + ((1LL << (n - 1)) ADD_TO_VAL_BESIDE_HALF)) >> n;            \
+static int32_t fix32_acc_scale(int64_t acc, int n)
+{
+    // use RHAZ rounding function by default
+#ifndef FIX32_MATH_MUL_ROUND_FUNC
+#define FIX32_MATH_MUL_ROUND_FUNC   fix32_scale_rhaz_64
+#endif
+
+    // round according to the desired scheme:
+    int64_t res = FIX32_MATH_MUL_ROUND_FUNC(acc, n);
+
+    // check for overflow if an overflow action was specified; skip otherwise:
+#ifdef FIX32_MATH_MUL_OVERFLOW_ACTION
+    // overflow occurs if any of the upper 33 bits are not equal (either 0 for
+    // a positive number or 1 for a negative number); we use (-1LL << 31) as a
+    // mask for those bits:
+    if (((res & (-1LL << 31)) != ((res >> 32) & (-1LL << 31)))) {
+        FIX32_MATH_MUL_OVERFLOW_ACTION(res);
+    }
+#endif
+    return res;
 }
-FIX32_MATH_SCALE_FUNCTION(int32_t, rhu_32, )                    // 32-bit RHU
-FIX32_MATH_SCALE_FUNCTION(int32_t, rhd_32, - 1)                 // 32-bit RHD
-FIX32_MATH_SCALE_FUNCTION(int32_t, rhaz_32, + (val >> 31))      // 32-bit RHAZ
-FIX32_MATH_SCALE_FUNCTION(int32_t, rhtz_32, + (~(val >> 31)))   // 32-bit RHTZ
-FIX32_MATH_SCALE_FUNCTION(int64_t, rhu_64, )                    // 64-bit RHU
-FIX32_MATH_SCALE_FUNCTION(int64_t, rhd_64, - 1)                 // 64-bit RHD
-FIX32_MATH_SCALE_FUNCTION(int64_t, rhaz_64, + (val >> 63))      // 64-bit RHAZ
-FIX32_MATH_SCALE_FUNCTION(int64_t, rhtz_64, + (~(val >> 63)))   // 64-bit RHTZ
 
 
 /**
@@ -95,52 +102,39 @@ FIX32_MATH_SCALE_FUNCTION(int64_t, rhtz_64, + (~(val >> 63)))   // 64-bit RHTZ
  */
 static int32_t fix32_mul(int32_t a, int32_t b, int n)
 {
-    // use RHAZ rounding function by default
-#ifndef FIX32_MATH_MUL_ROUND_FUNC
-#define FIX32_MATH_MUL_ROUND_FUNC   fix32_scale_rhaz_64
-#endif
-
-    // multiply a and b and round according to the desired scheme:
-    int64_t prod = FIX32_MATH_MUL_ROUND_FUNC((int64_t)a * b, n);
-
-    // check for overflow if an overflow action was specified; skip otherwise:
-#ifdef FIX32_MATH_MUL_OVERFLOW_ACTION
-    // overflow occurs if any of the upper 33 bits are not equal (either 0 for
-    // a positive number or 1 for a negative number); we use (-1LL << 31) as a
-    // mask for those bits:
-    if (((prod & (-1LL << 31)) != ((prod >> 32) & (-1LL << 31)))) {
-        FIX32_MATH_MUL_OVERFLOW_ACTION(prod);
-    }
-#endif
-    return prod;
+    return fix32_acc_scale((int64_t)a * b, n);
 }
 
 
 /**
- * Approximate the inverse square root of a 32-bit fixed point value with a
- * scaling factor of 2^scale.  Undefined for val = 0.
- *
- * The approximation is calculated using cubic interpolation and improved with
- * one or two iterations of Newton's method (see FIX32_INVSQRT_NEWTON_ITERS).
- * The relative error is less than 1 % with one iteration and less than 0.01 %
- * with two iterations.  The result is well-conditioned and smooth with
- * continuous first derivative.
+ * Saturating multiplication (see 'fix32base.h' for saturating addition and
+ * subtraction), using the rounding function selected for 'fix32_mul()':
  *
- * @param val   32-bit fixed point input value with scaling factor 2^scale
- * @param scale scaling factor power; input and output parameter
- * @return      32-bit fixed point inverse square root of val with a scaling
- *              factor of 2^scale, where scale has been modified in order to
- *              retain high precision; the result can safely be cast to signed.
+ *  - fix32_mul_sat():      like fix32_mul(), but with saturation instead of
+ *                          FIX32_MATH_MUL_OVERFLOW_ACTION
+ *  - fix32_acc_scale_sat(): like fix32_acc_scale(), but with saturation, i.e.
+ *                          the saturating end of a fix32_mac() chain
+ *  - fix32_mac_sat():      acc + a * b / 2^n for a 32-bit accumulator 'acc'
+ *                          (e.g., an integrator), with the product rounded
+ *                          and the sum saturated
  */
-uint32_t fix32_invsqrt(uint32_t val, int *scale);
+static int32_t fix32_acc_scale_sat(int64_t acc, int n)
+{
+    return fix32_sat_64(FIX32_MATH_MUL_ROUND_FUNC(acc, n));
+}
 
+static int32_t fix32_mul_sat(int32_t a, int32_t b, int n)
+{
+    return fix32_acc_scale_sat((int64_t)a * b, n);
+}
 
-/**
- * Rough approximation of atan2, i.e. the arcus tangens of y/x .
- *
- * @param x, y  32-bit fixed point input coordinates
- * @param scale scaling factor power of 2 of x and y
- * @return      32-bit fixed point arcus tangens of y/x with a scaling factor
- *              of 2^28
- */
-int32_t fix32_atan2(int32_t x, int32_t y, int scale);
+static int32_t fix32_mac_sat(int32_t acc, int32_t a, int32_t b, int n)
+{
+    return fix32_sat_64(acc + FIX32_MATH_MUL_ROUND_FUNC((int64_t)a * b, n));
+}
+
+
+// header-only mode: define the scalar functions in this translation unit
+#ifdef FIX32MATH_INLINE
+#include "fix32math_impl.h"
+#endif
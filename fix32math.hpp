@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 32-bit fixed-point computation: C++ interface to the
+ * multiplication with a rounding and overflow policy chosen per call site
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * The rounding and overflow policy are template parameters, hence resolved at
+ * compile time without any runtime dispatch:
+ *
+ *     int32_t a = fix32::mul(x, y, 30);                     // RHAZ, wrap
+ *     int32_t b = fix32::mul<FIX32_RHU>(x, y, 30);          // RHU, wrap
+ *     int32_t c = fix32::mul<FIX32_RHTZ, fix32::overflow::saturate>(x, y, 30);
+ *     int32_t d = fix32::mul<FIX32_RHAZ, fix32::overflow::check>(x, y, 30);
+ *
+ * Unlike 'fix32math.h', this header may be included any number of times and
+ * from header files, since it does not depend on any configuration macros.
+ */
+#ifndef FIX32MATH_HPP
+#define FIX32MATH_HPP
+
+#include "fix32base.h"
+
+namespace fix32 {
+
+
+/**
+ * Action taken when a result does not fit into 32 bits: either silently
+ * discard the higher bits, clamp to INT32_MAX or INT32_MIN, or call
+ * 'overflow_handler()' (the counterpart of FIX32_MATH_MUL_OVERFLOW_ACTION in
+ * 'fix32math.h').
+ */
+enum class overflow {
+    wrap,
+    saturate,
+    check
+};
+
+
+/**
+ * Overflow handler of the policy 'overflow::check', to be defined by the
+ * application if it uses that policy.  It receives the result in 64 bits and
+ * returns the 32-bit value to be used instead (e.g. after logging or
+ * signalling the error), unless it does not return at all.
+ */
+int32_t overflow_handler(int64_t val);
+
+
+/**
+ * Map a rounding flavour to the corresponding 64-bit scale function.
+ */
+template <fix32_rounding R> struct rounding_policy;
+
+template <> struct rounding_policy<FIX32_RHU> {
+    static int64_t scale(int64_t val, int n)
+    {
+        return fix32_scale_rhu_64(val, n);
+    }
+};
+template <> struct rounding_policy<FIX32_RHD> {
+    static int64_t scale(int64_t val, int n)
+    {
+        return fix32_scale_rhd_64(val, n);
+    }
+};
+template <> struct rounding_policy<FIX32_RHAZ> {
+    static int64_t scale(int64_t val, int n)
+    {
+        return fix32_scale_rhaz_64(val, n);
+    }
+};
+template <> struct rounding_policy<FIX32_RHTZ> {
+    static int64_t scale(int64_t val, int n)
+    {
+        return fix32_scale_rhtz_64(val, n);
+    }
+};
+
+
+/**
+ * Narrow a 64-bit value to 32 bits according to an overflow policy.
+ */
+template <overflow O> struct overflow_policy;
+
+template <> struct overflow_policy<overflow::wrap> {
+    static int32_t narrow(int64_t val) { return (int32_t)val; }
+    static int32_t add(int32_t a, int32_t b)
+    {
+        return (int32_t)((uint32_t)a + (uint32_t)b);
+    }
+    static int32_t sub(int32_t a, int32_t b)
+    {
+        return (int32_t)((uint32_t)a - (uint32_t)b);
+    }
+};
+template <> struct overflow_policy<overflow::saturate> {
+    static int32_t narrow(int64_t val) { return fix32_sat_64(val); }
+    static int32_t add(int32_t a, int32_t b) { return fix32_add_sat(a, b); }
+    static int32_t sub(int32_t a, int32_t b) { return fix32_sub_sat(a, b); }
+};
+template <> struct overflow_policy<overflow::check> {
+    static int32_t narrow(int64_t val)
+    {
+        if (val < INT32_MIN || val > INT32_MAX)
+            return overflow_handler(val);
+        return (int32_t)val;
+    }
+    static int32_t add(int32_t a, int32_t b) { return narrow((int64_t)a + b); }
+    static int32_t sub(int32_t a, int32_t b) { return narrow((int64_t)a - b); }
+};
+
+
+/**
+ * Round a 64-bit sum of products to a 32-bit fixed point number, i.e. scale
+ * it down by 2^n (see 'fix32_acc_scale()').
+ */
+template <fix32_rounding R = FIX32_RHAZ, overflow O = overflow::wrap>
+inline int32_t acc_scale(int64_t acc, int n)
+{
+    return overflow_policy<O>::narrow(rounding_policy<R>::scale(acc, n));
+}
+
+
+/**
+ * Multiply two fixed point numbers with scaling factor 2^n (see
+ * 'fix32_mul()').
+ */
+template <fix32_rounding R = FIX32_RHAZ, overflow O = overflow::wrap>
+inline int32_t mul(int32_t a, int32_t b, int n)
+{
+    return acc_scale<R, O>((int64_t)a * b, n);
+}
+
+
+/**
+ * Multiply-accumulate into a 64-bit accumulator without rounding (see
+ * 'fix32_mac()'); finish with 'acc_scale()'.
+ */
+inline int64_t mac(int64_t acc, int32_t a, int32_t b)
+{
+    return fix32_mac(acc, a, b);
+}
+
+
+/**
+ * acc + a * b / 2^n for a 32-bit accumulator 'acc', with the product rounded
+ * and the overflow policy applied to the sum (see 'fix32_mac_sat()').
+ */
+template <fix32_rounding R = FIX32_RHAZ, overflow O = overflow::wrap>
+inline int32_t mac(int32_t acc, int32_t a, int32_t b, int n)
+{
+    return overflow_policy<O>::narrow(
+        acc + rounding_policy<R>::scale((int64_t)a * b, n));
+}
+
+
+/**
+ * Addition and subtraction of fixed point numbers with the same scaling
+ * factor.
+ */
+template <overflow O = overflow::wrap>
+inline int32_t add(int32_t a, int32_t b)
+{
+    return overflow_policy<O>::add(a, b);
+}
+
+template <overflow O = overflow::wrap>
+inline int32_t sub(int32_t a, int32_t b)
+{
+    return overflow_policy<O>::sub(a, b);
+}
+
+
+} // namespace fix32
+
+#endif // FIX32MATH_HPP
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 32-bit fixed-point computation: implementation of the
+ * scalar functions 'fix32_invsqrt()', 'fix32_recip()', 'fix32_atan2()' and
+ * 'fix32_sincos()'
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * This file is compiled into the library by 'src/fix32math.c'.  If the macro
+ * FIX32MATH_INLINE is defined, it is instead included by 'fix32math.h' and the
+ * functions are defined as 'static inline' in every translation unit, which
+ * allows the compiler to inline them and to propagate constant arguments
+ * (such as the scaling factor).  'fix32constexpr.hpp' includes it a third way,
+ * with the macro FIX32_MATH_IMPL_CONSTEXPR defined, to obtain 'constexpr'
+ * definitions in its own namespace; these use the default configuration of
+ * 'fix32math.h' (RHAZ rounding without overflow action).  Do not include it
+ * anywhere else; each includer includes it at most once per translation unit.
+ */
+#if defined(FIX32_MATH_IMPL_CONSTEXPR)
+#define FIX32_MATH_IMPL_SPEC        constexpr inline
+#define FIX32_MATH_IMPL_ROUND_FUNC  fix32_scale_rhaz_64
+
+constexpr int32_t fix32_mul(int32_t a, int32_t b, int n)
+{
+    return fix32_mul_rhaz(a, b, n);
+}
+#elif defined(FIX32MATH_H)
+#define FIX32_MATH_IMPL_SPEC        FIX32_MATH_IMPL
+#define FIX32_MATH_IMPL_ROUND_FUNC  FIX32_MATH_MUL_ROUND_FUNC
+#else
+#error "ERROR: `fix32math_impl.h' must be included via `fix32math.h'"
+#endif
+
+
+/**
+ * Approximate the inverse square root using cubic interpolation refined with
+ * Newton's method.  Well-conditioned and smooth with continuous first
+ * derivative.  Accepts and returns unsigned 32-bit fixed point values with a
+ * scaling factor of 2^scale.  Undefined for val = 0.  Modifies scale to return
+ * a value with high precision.
+ */
+FIX32_MATH_IMPL_SPEC uint32_t fix32_invsqrt(uint32_t val, int *scale)
+{
+    // Let: val = a * 2^(2n) , with 1 <= a < 4
+    // then: sqrt(val) = sqrt(a) * 2^n
+
+    // As a prerequisite, scale must be even; if it is odd, val is doubled
+    // (or halved with rounding if its highest bit is set) and scale adjusted
+    if (*scale & 1) {
+        if (val & 0x80000000) {
+            val = (val >> 1) + (val & 1);
+            *scale -= 1;
+        } else {
+            val <<= 1;
+            *scale += 1;
+        }
+    }
+
+    // Let's start by extracting a; get the index of the highest set bit in
+    // 'val' (actually, that index has to be even, so it's either the index of
+    // the highest set bit or the index of the bit after the highest set bit).
+    int msb_even = 0;
+
+#if defined(__riscv) && !defined(FIX32_MATH_IMPL_CONSTEXPR)
+    // optimize MSB extraction for RISC-V with non-branching code
+    asm("li     t0, 0xffff\n\t"
+        "sltu   t0, t0, %1\n\t"
+        "slli   %0, t0, 4\n\t"
+        "srl    t1, %1, %0\n\t"
+
+        "li     t0, 0xff\n\t"
+        "sltu   t0, t0, t1\n\t"
+        "slli   t0, t0, 3\n\t"
+        "add    %0, %0, t0\n\t"
+        "srl    t1, t1, t0\n\t"
+
+        "li     t0, 0xf\n\t"
+        "sltu   t0, t0, t1\n\t"
+        "slli   t0, t0, 2\n\t"
+        "add    %0, %0, t0\n\t"
+        "srl    t1, t1, t0\n\t"
+
+        "li     t0, 0x3\n\t"
+        "sltu   t0, t0, t1\n\t"
+        "slli   t0, t0, 1\n\t"
+        "add    %0, %0, t0\n\t"
+
+        : "=r"(msb_even) : "r"(val) : "t0", "t1");
+#else
+    uint32_t val_copy = val;
+    if (val_copy & 0xFFFF0000) {
+        val_copy &= 0xFFFF0000;
+        msb_even += 16;
+    }
+    if (val_copy & 0xFF00FF00) {
+        val_copy &= 0xFF00FF00;
+        msb_even += 8;
+    }
+    if (val_copy & 0xF0F0F0F0) {
+        val_copy &= 0xF0F0F0F0;
+        msb_even += 4;
+    }
+    if (val_copy & 0xCCCCCCCC)
+        msb_even += 2;
+#endif
+
+    // extract 'a' by correctly shifting val; since 1 <= a < 4, it can be
+    // stored with a scaling factor of 2^30 for maximum precision
+    uint32_t a = val << (30 - msb_even);
+
+    // 'n' can be calculated from 'scale' and the highest bit index 'msb_even'
+    // (note that bit shifting instead of division also works for negative n
+    // since both 'msb_even' and '*scale' are even)
+    int n = (msb_even - *scale) >> 1;
+
+    // approximate 1/sqrt(a) with a scaling factor of 2^30
+    uint32_t res = fix32_invsqrt_norm(a);
+
+    // Finally, 1/sqrt(val) = 1/sqrt(a) * 2^(-n)
+    // The intermediate result has a scaling factor of 2^30; thus the scaling
+    // factor of the final result is 2^(30 + n) ; modify scale accordingly
+    *scale = 30 + n;
+
+    return res;
+}
+
+
+/**
+ * Rough approximation of atan2, i.e. the arcus tangens of y/x
+ */
+FIX32_MATH_IMPL_SPEC int32_t fix32_atan2(int32_t y, int32_t x, int scale)
+{
+    // The result only depends on the ratio of y and x, not on their scaling
+    // factor; x and y are normalized such that the highest set bit of the
+    // larger magnitude is at index 29, i.e. they are treated as values with a
+    // scaling factor of 2^30 and magnitude between 0.5 and 1.  This keeps all
+    // intermediate results in the same range regardless of the input format,
+    // so that neither large inputs overflow nor small inputs lose precision.
+    (void)scale;
+
+    uint32_t abs_x = (x >= 0) ? (uint32_t)x : -(uint32_t)x,
+             abs_y = (y >= 0) ? (uint32_t)y : -(uint32_t)y;
+
+    if ((abs_x | abs_y) == 0)
+        return 0;
+
+    int octant = (abs_x > abs_y) ? 0 : 1;
+    if (x < 0)
+        octant = 3 - octant;
+    if (y < 0)
+        octant = 7 - octant;
+
+    // index of the highest set bit of the larger magnitude
+    uint32_t mag = abs_x | abs_y;
+    int msb = 0;
+    if (mag & 0xFFFF0000) {
+        mag >>= 16;
+        msb += 16;
+    }
+    if (mag & 0xFF00) {
+        mag >>= 8;
+        msb += 8;
+    }
+    if (mag & 0xF0) {
+        mag >>= 4;
+        msb += 4;
+    }
+    if (mag & 0xC) {
+        mag >>= 2;
+        msb += 2;
+    }
+    if (mag & 0x2)
+        msb += 1;
+
+    if (msb > 29) {
+        x >>= msb - 29;
+        y >>= msb - 29;
+    } else {
+        x = (int32_t)((uint32_t)x << (29 - msb));
+        y = (int32_t)((uint32_t)y << (29 - msb));
+    }
+
+    // product of x and y, with a scaling factor of 2^28
+    int32_t x_y = fix32_mul(x, y, 32);
+
+    // squares of x and y, also with a scaling factor of 2^28
+    int32_t sq_x = fix32_mul(x, x, 32),
+            sq_y = fix32_mul(y, y, 32);
+
+    int32_t _28125 = 0x48000000; // 0.28125 with a scaling factor of 2^32
+
+    // 0.25 <= denum < 1.28125 with a scaling factor of 2^28
+    int32_t denum = 0;
+    switch (octant) {
+        case 7:
+        case 0:
+        case 3:
+        case 4:
+            denum = sq_x + fix32_mul(sq_y, _28125, 32);
+            break;
+
+        default: // 1, 2, 5, 6
+            denum = sq_y + fix32_mul(sq_x, _28125, 32);
+    }
+
+    int den_scale = 28;
+    int32_t inv_sqrt = fix32_invsqrt(denum, &den_scale); // den_scale altered
+
+    // inverse has scaling factor of 2^(2*den_scale - 32)
+    int32_t inv = fix32_mul(inv_sqrt, inv_sqrt, 32);
+
+    // the product x_y * inv has a scaling factor of 2^(2*den_scale - 4);
+    // target scale: 2^28 (den_scale is either 29 or 30)
+    int shift = 2 * den_scale - 32;
+
+    int32_t pi_half = 0x1921FB54, // pi/2 with a scaling factor of 2^28
+            pi      = 0x3243F6A9; // pi with a scaling factor of 2^28
+
+    switch (octant) {
+        case 7:
+        case 0:
+            return fix32_mul(x_y, inv, shift);
+
+        case 1:
+        case 2:
+            return pi_half - fix32_mul(x_y, inv, shift);
+
+        case 3:
+            return pi + fix32_mul(x_y, inv, shift);
+
+        case 4:
+            return -pi + fix32_mul(x_y, inv, shift);
+
+        case 5:
+        case 6:
+            return -pi_half - fix32_mul(x_y, inv, shift);
+    }
+
+    // not reached
+    return 0;
+}
+
+
+/**
+ * Approximate sine and cosine of an angle using polynomials
+ */
+FIX32_MATH_IMPL_SPEC void fix32_sincos(int32_t angle, int32_t *sin_val,
+                                      int32_t *cos_val)
+{
+    // Let: angle = q * pi/2 + r , with q integer and -pi/4 <= r <= pi/4
+    // then sin(angle) and cos(angle) are +/- sin(r) or +/- cos(r)
+
+    // q = round(angle * 2/pi) ; 2/pi with a scaling factor of 2^32 times
+    // angle with a scaling factor of 2^28 yields a scaling factor of 2^60
+    const int64_t _2_pi = 0xA2F9836E; // 2/pi with a scaling factor of 2^32
+    int64_t q = ((int64_t)angle * _2_pi + (1LL << 59)) >> 60;
+
+    // remainder r with a scaling factor of 2^30 (|r| <= pi/4 < 1)
+    const int64_t pi_half = 0x6487ED51; // pi/2 with a scaling factor of 2^30
+    int32_t r = (int64_t)angle * 4 - q * pi_half;
+
+    // r^2 with a scaling factor of 2^30 (r^2 <= pi^2/16 < 1)
+    int32_t r_squ = fix32_mul(r, r, 30);
+
+    // Taylor polynomials evaluated with Horner's method; the error of both
+    // polynomials is in the order of 2^-29 for |r| <= pi/4 (the truncated
+    // term r^11/11! of the sine alone is about 2^-29.1):
+    // sin(r) = r * (1 - r^2/6 * (1 - r^2/20 * (1 - r^2/42 * (1 - r^2/72))))
+    // cos(r) = 1 - r^2/2 * (1 - r^2/12 * (1 - r^2/30 * (1 - r^2/56 *
+    //                                                   (1 - r^2/90))))
+    // The reciprocals of the denominators have a scaling factor of 2^32.
+    const int32_t one = 1 << 30; // 1 with a scaling factor of 2^30
+    int32_t s = 0, c = 0;
+
+    s = one - fix32_mul(r_squ, 0x038E38E4, 32);                   // 1/72
+    s = one - fix32_mul(fix32_mul(r_squ, s, 30), 0x06186186, 32); // 1/42
+    s = one - fix32_mul(fix32_mul(r_squ, s, 30), 0x0CCCCCCD, 32); // 1/20
+    s = one - fix32_mul(fix32_mul(r_squ, s, 30), 0x2AAAAAAB, 32); // 1/6
+    s = fix32_mul(r, s, 30);
+
+    c = one - fix32_mul(r_squ, 0x02D82D83, 32);                   // 1/90
+    c = one - fix32_mul(fix32_mul(r_squ, c, 30), 0x04924925, 32); // 1/56
+    c = one - fix32_mul(fix32_mul(r_squ, c, 30), 0x08888889, 32); // 1/30
+    c = one - fix32_mul(fix32_mul(r_squ, c, 30), 0x15555555, 32); // 1/12
+    c = one - fix32_mul(r_squ, c, 31);                            // 1/2
+
+    switch (q & 3) {
+        case 0:
+            *sin_val = s;
+            *cos_val = c;
+            break;
+
+        case 1:
+            *sin_val = c;
+            *cos_val = -s;
+            break;
+
+        case 2:
+            *sin_val = -s;
+            *cos_val = -c;
+            break;
+
+        default: // 3
+            *sin_val = -c;
+            *cos_val = s;
+    }
+}
+
+
+/**
+ * Approximate the reciprocal of a 32-bit fixed point value
+ */
+FIX32_MATH_IMPL_SPEC int32_t fix32_recip(int32_t val, int *scale)
+{
+    uint32_t abs_val = (val < 0) ? -(uint32_t)val : (uint32_t)val;
+
+    // 1/val = (1/sqrt(val))^2 ; the inverse square root is at most 1 with a
+    // scaling factor of 2^30, thus its square is at most 1 with a scaling
+    // factor of 2^60, which is reduced to a scaling factor of 2^30
+    int inv_scale = *scale;
+    uint32_t inv = fix32_invsqrt(abs_val, &inv_scale);
+    int32_t res = ((uint64_t)inv * inv + (1uLL << 29)) >> 30;
+    int res_scale = inv_scale + inv_scale - 30;
+
+    // The relative error of the square is about twice the relative error of
+    // the inverse square root; refine the result with one iteration of
+    // Newton's method: res = res + res * (1 - val * res)
+
+    // val * res is approximately 1 with a scaling factor of 2^prod_scale
+    int prod_scale = *scale + res_scale;
+    int64_t err = (1LL << prod_scale) - (int64_t)((uint64_t)abs_val * res);
+
+    // bring the error to a scaling factor of 2^30 (prod_scale >= 28)
+    int shift = prod_scale - 30;
+    int32_t err_30 = (shift > 0) ? FIX32_MATH_IMPL_ROUND_FUNC(err, shift)
+                                 : err * (1 << -shift);
+
+    res += fix32_mul(res, err_30, 30);
+
+    *scale = res_scale;
+    return (val < 0) ? -res : res;
+}
+
+
+#undef FIX32_MATH_IMPL_SPEC
+#undef FIX32_MATH_IMPL_ROUND_FUNC
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Phase accumulator (NCO) and phase unwrapping for libfix32math
+ *
+ * Two phase formats are used:
+ *
+ *  - radians with a scaling factor of 2^28, as returned by 'fix32_atan2()',
+ *    in the interval [-pi, pi] for wrapped phases;
+ *
+ *  - turns with a scaling factor of 2^32 as unsigned 32-bit integer, such that
+ *    a full turn equals 2^32 and the phase wraps around naturally on overflow
+ *    (i.e., 2^30 is pi/2 and 2^31 is pi or -pi).
+ *
+ * The sine and cosine of phases in turns are obtained from the sine table
+ * generated at build time (see tools/gensintab.c) with linear interpolation;
+ * with the default table of 2^FIX32_SINTAB_BITS = 4096 steps per turn the
+ * absolute error is below 2^-21.
+ */
+
+#ifndef FIX32NCO_H
+#define FIX32NCO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fix32cmplx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Convert a phase in radians with a scaling factor of 2^28 to turns with a
+ * scaling factor of 2^32 (wrapping around modulo a full turn) and vice versa
+ * (the result is in the interval [-pi, pi)).
+ */
+uint32_t fix32_rad_to_turn(int32_t rad);
+int32_t fix32_turn_to_rad(uint32_t turn);
+
+/**
+ * Sine and cosine of a phase in turns with a scaling factor of 2^30.
+ */
+void fix32_sincos_turn(uint32_t turn, int32_t *sin_val, int32_t *cos_val);
+
+
+/**
+ * Numerically controlled oscillator: a phase accumulator in turns which is
+ * advanced by 'freq' (i.e., the frequency in turns per sample with a scaling
+ * factor of 2^32) for every output sample.
+ */
+typedef struct fix32_nco {
+    uint32_t phase; // current phase in turns
+    uint32_t freq;  // phase increment per sample in turns
+} fix32_nco;
+
+void fix32_nco_init(fix32_nco *nco, uint32_t freq, uint32_t phase);
+
+/**
+ * Generate 'count' samples of the complex oscillator exp(i phase), i.e. the
+ * cosine as real part and the sine as imaginary part, with a scaling factor
+ * of 2^30.
+ */
+void fix32_nco_process(fix32_nco *nco, fix32_cmplx *out, size_t count);
+
+
+/**
+ * Phase unwrapper for a stream of wrapped phases in radians with a scaling
+ * factor of 2^28 (e.g., the output of 'fix32_atan2()'): whenever the phase
+ * jumps by more than pi between consecutive samples, a multiple of 2 pi is
+ * added such that the jump is at most pi.  The unwrapped phase is written as
+ * 64-bit value in radians with a scaling factor of 2^28, as it may exceed the
+ * range of 32 bits.  The state is retained across blocks.
+ */
+typedef struct fix32_unwrap {
+    int32_t prev;   // last wrapped phase of the previous block
+    int64_t acc;    // last unwrapped phase of the previous block
+} fix32_unwrap;
+
+void fix32_unwrap_init(fix32_unwrap *unwrap);
+void fix32_unwrap_process(fix32_unwrap *unwrap, const int32_t *in,
+                          int64_t *out, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32NCO_H
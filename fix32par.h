@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Parallel execution of batched kernels for libfix32math
+ *
+ * A pool of POSIX threads splits a batch of 'count' elements into one
+ * contiguous range per thread (static partitioning); each thread processes
+ * its range in chunks of a cache-sized number of elements.  Since the
+ * partition only depends on the number of elements and threads, buffers can
+ * be initialized with 'fix32_par_touch()' using the same partition, such
+ * that on NUMA systems the memory pages of each range are allocated on the
+ * node of the thread processing it (first-touch policy).
+ *
+ * The pool is optional ('make PTHREAD=1') and has no dependencies except
+ * for pthreads.  Without a preceding call of 'fix32_par_init()' (or with a
+ * single thread) all functions run in the calling thread.  The functions
+ * must not be called concurrently from several threads or from within a
+ * kernel executed by the pool.
+ */
+
+#ifndef FIX32PAR_H
+#define FIX32PAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fix32base.h"
+#include "fix32cmplx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Default chunk size in bytes (input plus output data) processed at once by
+ * a thread, which should fit into the L2 cache of a core
+ */
+#ifndef FIX32_PAR_CHUNK_BYTES
+#define FIX32_PAR_CHUNK_BYTES (256 * 1024)
+#endif
+
+
+/**
+ * Start a pool of 'threads' threads (including the calling thread), or one
+ * thread per online processor for 0.  Returns the number of threads or -1 if
+ * threads could not be created (the calling thread is then used alone).
+ */
+int fix32_par_init(unsigned threads);
+
+/**
+ * Stop the threads of the pool.
+ */
+void fix32_par_shutdown(void);
+
+/**
+ * Kernel applied to the elements [beg, end) of a batch; 'ctx' is passed
+ * through from 'fix32_par_for()'.
+ */
+typedef void (*fix32_par_kernel)(size_t beg, size_t end, void *ctx);
+
+/**
+ * Apply 'kernel' to the elements [0, count) in parallel, in chunks of at
+ * most 'chunk' elements (or the whole range of a thread for 0), and return
+ * when all elements have been processed.
+ */
+void fix32_par_for(size_t count, size_t chunk, fix32_par_kernel kernel,
+                   void *ctx);
+
+/**
+ * Zero the 'count' elements of 'elem_size' bytes of 'buf' using the same
+ * partition as 'fix32_par_for()' for NUMA-friendly first-touch allocation.
+ */
+void fix32_par_touch(void *buf, size_t count, size_t elem_size);
+
+
+/**
+ * Parallel variants of batched kernels with the same semantics as the
+ * respective sequential ones (see 'fix32base.h', 'fix32cmplx.h' and
+ * 'fix32conv.h').
+ */
+void fix32_par_invsqrt_array(const uint32_t *src, int32_t *dst, size_t count,
+                             int scale, int res_scale);
+void fix32_par_cmplx_phase_array(const fix32_cmplx *a, int32_t *phase,
+                                 size_t count);
+void fix32_par_from_float(const float *src, int32_t *dst, size_t count,
+                          int scale, fix32_rounding rounding);
+void fix32_par_from_double(const double *src, int32_t *dst, size_t count,
+                           int scale, fix32_rounding rounding);
+void fix32_par_to_float(const int32_t *src, float *dst, size_t count,
+                        int scale);
+void fix32_par_to_double(const int32_t *src, double *dst, size_t count,
+                         int scale);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32PAR_H
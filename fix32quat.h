@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Quaternion math for libfix32math
+ *
+ * Quaternions are stored as 4 signed 32-bit fixed point components.  Unit
+ * quaternions (i.e., rotations) use a scaling factor of 2^30, which is also
+ * the scaling factor of the output of all normalization functions.  Sums of
+ * products are accumulated in 64 bits and rounded once per component with
+ * the rounding function selected for 'fix32_mul()'.
+ */
+
+#ifndef FIX32QUAT_H
+#define FIX32QUAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct fix32_quat {
+    int32_t w, x, y, z;
+} fix32_quat;
+
+
+/**
+ * Hamilton product res = a * b of two quaternions with scaling factor 2^n.
+ * The components of a and b should not exceed 2^30 in magnitude to avoid
+ * overflow of the 64-bit accumulators.
+ */
+void fix32_quat_mul(const fix32_quat *a, const fix32_quat *b, fix32_quat *res,
+                    int n);
+
+/**
+ * Normalize a quaternion of arbitrary scale to a unit quaternion with scaling
+ * factor 2^30 (see 'fix32_vec4_normalize()').  A zero quaternion yields zero.
+ */
+void fix32_quat_normalize(const fix32_quat *q, fix32_quat *res);
+
+/**
+ * Fast renormalization of a nearly normalized quaternion with scaling factor
+ * 2^30, e.g. after integrating an angular rate.  Instead of computing the
+ * inverse square root of the squared norm |q|^2 it is approximated by a single
+ * Newton iteration starting at 1, i.e. (3 - |q|^2) / 2, whose error is in the
+ * order of (|q|^2 - 1)^2.  Use 'fix32_quat_normalize()' if |q| may deviate
+ * from 1 by more than about 1 %.
+ */
+void fix32_quat_renormalize(const fix32_quat *q, fix32_quat *res);
+
+/**
+ * Rotate the 3-D vector 'v' (of arbitrary scale) by the unit quaternion 'q'
+ * (with a scaling factor of 2^30) and write the result to 'res'; 'v' and
+ * 'res' may be identical.  The components of 'v' should not exceed 2^30 in
+ * magnitude.
+ */
+void fix32_quat_rotate(const fix32_quat *q, const int32_t v[3],
+                       int32_t res[3]);
+
+/**
+ * Normalized linear interpolation between the unit quaternions 'a' and 'b'
+ * along the shorter arc; 't' is the interpolation parameter in the interval
+ * [0, 1] with a scaling factor of 2^30.  The result is a unit quaternion.
+ */
+void fix32_quat_nlerp(const fix32_quat *a, const fix32_quat *b, int32_t t,
+                      fix32_quat *res);
+
+/**
+ * Spherical linear interpolation between the unit quaternions 'a' and 'b'
+ * along the shorter arc; 't' is the interpolation parameter in the interval
+ * [0, 1] with a scaling factor of 2^30.  The angle between 'a' and 'b' is
+ * obtained with 'fix32_atan2()', thus the interpolation is only roughly
+ * uniform in angle; the result is renormalized to a unit quaternion.  Falls
+ * back to 'fix32_quat_nlerp()' for nearly identical quaternions.
+ */
+void fix32_quat_slerp(const fix32_quat *a, const fix32_quat *b, int32_t t,
+                      fix32_quat *res);
+
+
+/**
+ * Batched variants operating on arrays of 'count' quaternions or vectors;
+ * input and output arrays may be identical.
+ *
+ * 'fix32_quat_rotate_array()' rotates 'count' 3-D vectors stored consecutively
+ * in 'src' by the same unit quaternion 'q'; it converts 'q' to a rotation
+ * matrix once, which reduces the work per vector to 9 multiplications.
+ */
+void fix32_quat_mul_array(const fix32_quat *a, const fix32_quat *b,
+                          fix32_quat *res, size_t count, int n);
+void fix32_quat_renormalize_array(const fix32_quat *q, fix32_quat *res,
+                                  size_t count);
+void fix32_quat_rotate_array(const fix32_quat *q, const int32_t *src,
+                             int32_t *dst, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32QUAT_H
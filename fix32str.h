@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Decimal string conversion of fixed point numbers for libfix32math
+ *
+ * Fixed point numbers with a scaling factor of 2^scale (with 0 <= scale <=
+ * 32) are converted directly from and to decimal strings, without going
+ * through floating point.  Both directions are exact: the formatted string is
+ * the exact value rounded to the requested number of fractional digits (ties
+ * to even, identical to the output of printf("%.*f") for the exact value),
+ * and parsed strings are rounded with the flavours of the 'fix32_scale_*()'
+ * group (see 'fix32base.h') regardless of the number of digits.
+ *
+ * None of the functions allocate memory; the caller provides the buffers.
+ */
+
+#ifndef FIX32STR_H
+#define FIX32STR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fix32base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Maximum length (without terminating null character) of a fixed point number
+ * formatted with 'digits' fractional digits
+ */
+#define FIX32_STR_LEN(digits) (12 + (digits))
+
+/**
+ * Format the fixed point number 'val' with a scaling factor of 2^scale as a
+ * decimal string with 'digits' fractional digits (no decimal point for 0).
+ * 'str' must provide space for FIX32_STR_LEN(digits) + 1 characters.  Returns
+ * the length of the string (excluding the terminating null character).
+ */
+size_t fix32_to_str(int32_t val, char *str, int scale, unsigned digits);
+
+/**
+ * Format the 'count' fixed point numbers of 'src' as with 'fix32_to_str()',
+ * each followed by the separator 'sep' except for the last one, which is
+ * followed by a null character.  'dst' must provide space for
+ * count * (FIX32_STR_LEN(digits) + 1) characters.  Returns the length of the
+ * string (excluding the terminating null character).
+ */
+size_t fix32_to_str_array(const int32_t *src, char *dst, size_t count,
+                          int scale, unsigned digits, char sep);
+
+/**
+ * Parse a decimal number (leading white space, an optional sign, digits and
+ * an optional decimal point followed by more digits; no exponent) and
+ * convert it to a fixed point number with a scaling factor of 2^scale,
+ * rounded as specified by 'rounding' and saturated to INT32_MIN or
+ * INT32_MAX.  If 'end' is not NULL, it receives a pointer to the character
+ * following the number, or 'str' if no number was found (0 is returned).
+ */
+int32_t fix32_from_str(const char *str, const char **end, int scale,
+                       fix32_rounding rounding);
+
+/**
+ * Parse up to 'count' numbers from 'src' as with 'fix32_from_str()', which
+ * are separated by white space and/or a single comma.  Parsing stops at the
+ * first string that is not a number.  If 'end' is not NULL, it receives a
+ * pointer to the character following the last number.  Returns the number
+ * of parsed values.
+ */
+size_t fix32_from_str_array(const char *src, int32_t *dst, size_t count,
+                            int scale, fix32_rounding rounding,
+                            const char **end);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32STR_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Vector normalization kernels for libfix32math
+ *
+ * Vectors of 2, 3 or 4 signed 32-bit components are normalized to unit length
+ * using a single call of 'fix32_invsqrt()' per vector.  The squared length is
+ * accumulated in 64 bits and the components of the unit vector are rounded
+ * once with the rounding function selected for 'fix32_mul()'.  Since the
+ * direction of a vector does not depend on the scaling factor of its
+ * components, the input scaling factor is irrelevant; the output components
+ * always have a scaling factor of 2^30 (i.e., 1.0 is represented by 2^30).
+ *
+ * Each kernel exists for an array of vectors (AoS, components of a vector are
+ * stored consecutively) and for separate component arrays (SoA).  Input and
+ * output arrays may be identical for in-place normalization.  Zero vectors
+ * are normalized to zero vectors.  Vectors of 4 components must not have all
+ * of their components equal to -2^31.
+ */
+
+#ifndef FIX32VEC_H
+#define FIX32VEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Normalize 'count' vectors stored consecutively in 'src' (i.e., 'src' holds
+ * 2 * count, 3 * count or 4 * count values) and write the unit vectors to
+ * 'dst' with a scaling factor of 2^30.
+ */
+void fix32_vec2_normalize(const int32_t *src, int32_t *dst, size_t count);
+void fix32_vec3_normalize(const int32_t *src, int32_t *dst, size_t count);
+void fix32_vec4_normalize(const int32_t *src, int32_t *dst, size_t count);
+
+
+/**
+ * Normalize 'count' vectors stored as separate component arrays (x, y, z, w)
+ * and write the components of the unit vectors to the arrays (ux, uy, uz, uw)
+ * with a scaling factor of 2^30.
+ */
+void fix32_vec2_normalize_soa(const int32_t *x, const int32_t *y,
+                              int32_t *ux, int32_t *uy, size_t count);
+void fix32_vec3_normalize_soa(const int32_t *x, const int32_t *y,
+                              const int32_t *z,
+                              int32_t *ux, int32_t *uy, int32_t *uz,
+                              size_t count);
+void fix32_vec4_normalize_soa(const int32_t *x, const int32_t *y,
+                              const int32_t *z, const int32_t *w,
+                              int32_t *ux, int32_t *uy, int32_t *uz,
+                              int32_t *uw, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX32VEC_H
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Math library for 64-bit fixed-point computation
+ *
+ * Hosted at: https://github.com/michael-platzer/libfix32math
+ */
+
+
+/**
+ * The 64-bit companion of 'fix32math.h' follows the same conventions: a
+ * fixed point number 'val' with a scaling factor of 2^scale represents the
+ * value val / 2^scale, products are rounded to nearest with half rounded away
+ * from zero and overflow wraps around silently.
+ *
+ * Intermediate products have 128 bits and are represented by 'fix64_i128',
+ * which is computed with the compiler's 128-bit integer type where available
+ * (__int128, e.g. on 64-bit hosts) and with 32-bit partial products
+ * otherwise.  Unlike 'fix32math.h', this header may be included any number of
+ * times.
+ */
+#ifndef FIX64MATH_H
+#define FIX64MATH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Signed 128-bit integer with the value hi * 2^64 + lo .
+ */
+typedef struct fix64_i128 {
+    uint64_t lo;
+    int64_t  hi;
+} fix64_i128;
+
+#ifdef __SIZEOF_INT128__
+static fix64_i128 fix64_from_int128(__int128 val)
+{
+    fix64_i128 res;
+    res.lo = (uint64_t)val;
+    res.hi = (int64_t)(val >> 64);
+    return res;
+}
+
+static __int128 fix64_to_int128(fix64_i128 val)
+{
+    return (__int128)(((unsigned __int128)(uint64_t)val.hi << 64) | val.lo);
+}
+#endif
+
+
+/**
+ * Full 128-bit product of two signed 64-bit integers.
+ */
+static fix64_i128 fix64_mul_128(int64_t a, int64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    return fix64_from_int128((__int128)a * b);
+#else
+    // unsigned product from four 32-bit partial products
+    uint64_t ua = a, ub = b;
+    uint64_t p0 = (ua & 0xFFFFFFFFu) * (ub & 0xFFFFFFFFu),
+             p1 = (ua & 0xFFFFFFFFu) * (ub >> 32),
+             p2 = (ua >> 32)         * (ub & 0xFFFFFFFFu),
+             p3 = (ua >> 32)         * (ub >> 32);
+    uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    uint64_t hi  = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+
+    // signed correction: a negative operand contributes 2^64 times the other
+    // operand too much to the unsigned product
+    hi -= ub & (uint64_t)(a >> 63);
+    hi -= ua & (uint64_t)(b >> 63);
+
+    fix64_i128 res;
+    res.lo = (mid << 32) | (p0 & 0xFFFFFFFFu);
+    res.hi = (int64_t)hi;
+    return res;
+#endif
+}
+
+
+/**
+ * Sum of two 128-bit integers.
+ */
+static fix64_i128 fix64_add_128(fix64_i128 a, fix64_i128 b)
+{
+    fix64_i128 res;
+    res.lo = a.lo + b.lo;
+    res.hi = (int64_t)((uint64_t)a.hi + (uint64_t)b.hi + (res.lo < a.lo));
+    return res;
+}
+
+
+/**
+ * Scale down a signed 128-bit number by 2^n (with 1 <= n <= 127), returning
+ * the lower 64 bits of the result, with rounding to nearest in the flavours
+ * of the 'fix32_scale_*()' group (RHU, RHD, RHAZ and RHTZ; see
+ * 'fix32base.h').
+ */
+// shift with rounding; 'adj' (0 or -1) is added to val besides 2^(n-1):
+static int64_t fix64_round_shift_128(fix64_i128 val, int n, int64_t adj)
+{
+#ifdef __SIZEOF_INT128__
+    __int128 v = fix64_to_int128(val);
+    return (int64_t)((v + (((__int128)1 << (n - 1)) + adj)) >> n);
+#else
+    fix64_i128 half, add;
+    half.lo = (n <= 64) ? 1uLL << ((n - 1) & 63) : 0;
+    half.hi = (n <= 64) ? 0 : 1LL << ((n - 65) & 63);
+    add.lo  = (uint64_t)adj;
+    add.hi  = adj;
+    val = fix64_add_128(fix64_add_128(val, half), add);
+    if (n < 64)
+        return (int64_t)((val.lo >> n) | ((uint64_t)val.hi << (64 - n)));
+    return val.hi >> (n - 64);
+#endif
+}
+// scale function template; allows to specify the function name extension and
+// what else to add to val besides 2^(n-1) before shifting:
+#define FIX64_MATH_SCALE_FUNCTION(NAME_SUFFIX, ADD_TO_VAL_BESIDE_HALF)        \
+static int64_t fix64_scale_##NAME_SUFFIX (fix64_i128 val, int n) {            \
+    return fix64_round_shift_128(val, n, ADD_TO_VAL_BESIDE_HALF);             \
+}
+FIX64_MATH_SCALE_FUNCTION(rhu_128, 0)                           // RHU
+FIX64_MATH_SCALE_FUNCTION(rhd_128, -1)                          // RHD
+FIX64_MATH_SCALE_FUNCTION(rhaz_128, val.hi >> 63)               // RHAZ
+FIX64_MATH_SCALE_FUNCTION(rhtz_128, ~(val.hi >> 63))            // RHTZ
+
+
+/**
+ * Multiply-accumulate and multiplication of 64-bit fixed point numbers (see
+ * 'fix32_mac()', 'fix32_acc_scale()' and 'fix32_mul()'):
+ *
+ *  - fix64_mac(acc, a, b):   acc + a * b in 128 bits without rounding
+ *  - fix64_acc_scale(acc, n): round a 128-bit accumulator to 64 bits
+ *  - fix64_mul(a, b, n):     a * b / 2^n , rounded
+ *
+ * with 1 <= n <= 127.  Rounding is RHAZ; use the 'fix64_scale_*_128()'
+ * functions with 'fix64_mul_128()' for other rounding flavours.
+ */
+static fix64_i128 fix64_mac(fix64_i128 acc, int64_t a, int64_t b)
+{
+    return fix64_add_128(acc, fix64_mul_128(a, b));
+}
+
+static int64_t fix64_acc_scale(fix64_i128 acc, int n)
+{
+    return fix64_scale_rhaz_128(acc, n);
+}
+
+static int64_t fix64_mul(int64_t a, int64_t b, int n)
+{
+    return fix64_scale_rhaz_128(fix64_mul_128(a, b), n);
+}
+
+
+/**
+ * Approximate the inverse square root of a 64-bit fixed point value with a
+ * scaling factor of 2^scale.  Undefined for val = 0.
+ *
+ * The result of 'fix32_invsqrt()' for the upper 32 bits is refined with three
+ * iterations of Newton's method in 64 bits; the relative error is in the
+ * order of 2^-60.
+ *
+ * @param val   64-bit fixed point input value with scaling factor 2^scale
+ * @param scale scaling factor power; input and output parameter
+ * @return      64-bit fixed point inverse square root of val with a scaling
+ *              factor of 2^scale, where scale has been modified in order to
+ *              retain high precision; the result can safely be cast to signed.
+ */
+uint64_t fix64_invsqrt(uint64_t val, int *scale);
+
+
+/**
+ * Approximate the square root of a 64-bit fixed point value with a scaling
+ * factor of 2^scale, as val times its inverse square root (the relative error
+ * is in the order of 2^-60).  Returns 0 (with scale unchanged) for val = 0.
+ *
+ * @param val   64-bit fixed point input value with scaling factor 2^scale
+ * @param scale scaling factor power; input and output parameter
+ * @return      64-bit fixed point square root of val with a scaling factor of
+ *              2^scale, where scale has been modified in order to retain high
+ *              precision; the result can safely be cast to signed.
+ */
+uint64_t fix64_sqrt(uint64_t val, int *scale);
+
+
+/**
+ * Approximate atan2, i.e. the arcus tangens of y/x , with CORDIC iterations.
+ * The absolute error is in the order of 2^-56; returns 0 for x = y = 0.
+ *
+ * @param y, x  64-bit fixed point input coordinates
+ * @param scale scaling factor power of 2 of x and y; the result does not
+ *              depend on it (x and y only need to share the same scale)
+ * @return      64-bit fixed point arcus tangens of y/x with a scaling factor
+ *              of 2^60
+ */
+int64_t fix64_atan2(int64_t y, int64_t x, int scale);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIX64MATH_H
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix15math.h"
+
+
+/**
+ * Index of the highest set bit of a non-zero value below 2^16 (branch-free)
+ */
+static int fix15_msb(uint32_t val)
+{
+    int msb = 0, shift;
+    shift = (val > 0xFF) << 3;
+    val >>= shift;
+    msb += shift;
+    shift = (val > 0xF) << 2;
+    val >>= shift;
+    msb += shift;
+    shift = (val > 0x3) << 1;
+    val >>= shift;
+    msb += shift;
+    return msb + (val > 0x1);
+}
+
+
+/**
+ * Element-wise multiplication
+ */
+void fix15_mul_array(const int16_t *a, const int16_t *b, int16_t *res,
+                     size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        res[i] = fix15_mul(a[i], b[i]);
+}
+
+
+/**
+ * Dot product with a single final rounding
+ */
+int32_t fix15_dot(const int16_t *a, const int16_t *b, size_t count, int n)
+{
+    int64_t acc = 0;
+    size_t i;
+    for (i = 0; i < count; i++)
+        acc += (int32_t)a[i] * b[i];
+    return (int32_t)((acc + (1LL << (n - 1))) >> n);
+}
+
+
+/**
+ * Inverse square root of val (with 0 < val < 2^16) with a scaling factor of
+ * 2^scale; returns the result with a scaling factor of 2^14 and stores the
+ * power n such that the actual result is the returned one times 2^-n.
+ */
+static int32_t fix15_invsqrt_core(uint32_t val, int scale, int *n)
+{
+    // Let: val = a * 2^(2n) , with 1 <= a < 4 ; the exponent e = 2n + scale
+    // has the parity of scale and is the highest set bit of val or one less
+    int msb = fix15_msb(val);
+    int e = msb - ((msb - scale) & 1);
+    *n = (e - scale) >> 1;
+
+    // 'a' with a scaling factor of 2^13 (e >= -1, hence a right shift)
+    int32_t a = (val << 16) >> (e + 3);
+
+    // cubic approximation of 1/sqrt(a) (see 'fix32_invsqrt()') with Horner's
+    // method; the coefficients have a scaling factor of 2^15:
+    // p(a) = -11/432 a^3 + 19/72 a^2 - 137/144 a + 185/108
+    int32_t res = -834;                                      // -11/432
+    res = ((res * a + (1 << 12)) >> 13) + 8647;              //  19/72
+    res = ((res * a + (1 << 12)) >> 13) - 31175;             // -137/144
+    res = ((res * a + (1 << 12)) >> 13) + 56130;             //  185/108
+
+    // two iterations of Newton's method: res = res * (1.5 - a * res^2 / 2) ,
+    // with res having a scaling factor of 2^15
+    int i;
+    for (i = 0; i < 2; i++) {
+        int32_t res_squ = (res * res + (1 << 14)) >> 15;            // 2^15
+        int32_t half_a_res_squ = (a * res_squ + (1 << 13)) >> 14;   // 2^15
+        res = (res * (49152 - half_a_res_squ) + (1 << 14)) >> 15;   // 2^15
+    }
+
+    // 0.5 < res <= 1 ; reduce the scaling factor to 2^14 to fit into 16 bits
+    return (res + 1) >> 1;
+}
+
+
+/**
+ * Inverse square root
+ */
+int16_t fix15_invsqrt(int16_t val, int *scale)
+{
+    int n;
+    int16_t res = fix15_invsqrt_core((uint16_t)val, *scale, &n);
+    *scale = 14 + n;
+    return res;
+}
+
+void fix15_invsqrt_array(const int16_t *src, int16_t *dst, size_t count,
+                         int scale, int res_scale)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        int n;
+        int32_t res = fix15_invsqrt_core((uint16_t)src[i], scale, &n);
+
+        // bring the result from a scaling factor of 2^(14 + n) to
+        // 2^res_scale; since res <= 2^14, left shifts by more than 16 bits
+        // saturate anyway
+        int shift = 14 + n - res_scale;
+        if (shift > 0) {
+            shift = (shift < 31) ? shift : 31;
+            res = (res + ((1 << shift) >> 1)) >> shift;
+        } else {
+            res <<= (-shift < 16) ? -shift : 16;
+        }
+        dst[i] = (res > INT16_MAX) ? INT16_MAX : res;
+    }
+}
+
+
+/**
+ * Approximate atan2 with the arcus tangens of the ratio of the smaller and the
+ * larger magnitude as odd polynomial; the scalar variant uses the array
+ * variant, since the loop body must not contain a function call in order to
+ * be vectorized
+ */
+void fix15_atan2_array(const int16_t *y, const int16_t *x, int16_t *res,
+                       size_t count)
+{
+    size_t j;
+    for (j = 0; j < count; j++) {
+        int32_t  yj = y[j], xj = x[j];
+        uint32_t abs_x = (xj < 0) ? -xj : xj,
+                 abs_y = (yj < 0) ? -yj : yj;
+        uint32_t max = (abs_x > abs_y) ? abs_x : abs_y,
+                 min = (abs_x > abs_y) ? abs_y : abs_x;
+
+        // x = y = 0 yields 0 also with max = 1, which avoids a branch
+        max += (max == 0);
+
+        // normalize such that max << k is in the interval [2^15, 2^16)
+        int k = 15 - fix15_msb(max);
+        uint32_t m   = (max << k) >> 1, // max / 2^(15 - k) with scale 2^15
+                 num = min << k;        // min / 2^(15 - k) with scale 2^16
+
+        // reciprocal 1/m (with 0.5 <= m < 1) with a scaling factor of 2^15,
+        // using the linear approximation 48/17 - 32/17 m (relative error below
+        // 1/17) and three iterations of Newton's method: r = r * (2 - m * r)
+        uint32_t r = 92521 - ((61681 * m + (1u << 14)) >> 15);
+        uint32_t m_r;
+        m_r = (m * r + (1u << 14)) >> 15;
+        r   = (r * (65536 - m_r) + (1u << 14)) >> 15;
+        m_r = (m * r + (1u << 14)) >> 15;
+        r   = (r * (65536 - m_r) + (1u << 14)) >> 15;
+        m_r = (m * r + (1u << 14)) >> 15;
+        r   = (r * (65536 - m_r) + (1u << 14)) >> 15;
+
+        // ratio 0 <= t = min / max <= 1 with a scaling factor of 2^15
+        int32_t t = (num * r + (1u << 15)) >> 16;
+        t = (t < 32768) ? t : 32768;
+
+        // atan(t) = t * (a1 + a3 t^2 + a5 t^4 + a7 t^6 + a9 t^8) , with an
+        // absolute error below 1e-5 for |t| <= 1 (Abramowitz and Stegun,
+        // 4.4.49); the coefficients have a scaling factor of 2^15
+        int32_t t_squ = (t * t + (1 << 14)) >> 15;
+        int32_t p = 683;                                         //  0.0208351
+        p = ((p * t_squ + (1 << 14)) >> 15) - 2790;              // -0.0851330
+        p = ((p * t_squ + (1 << 14)) >> 15) + 5903;              //  0.1801410
+        p = ((p * t_squ + (1 << 14)) >> 15) - 10823;             // -0.3302995
+        p = ((p * t_squ + (1 << 14)) >> 15) + 32764;             //  0.9998660
+
+        // angle in the first octant with a scaling factor of 2^13
+        int32_t angle = (t * p + (1 << 16)) >> 17;
+
+        // map to the actual octant (pi/2 and pi with a scaling factor of 2^13)
+        angle = (abs_y > abs_x) ? 12868 - angle : angle;
+        angle = (xj < 0) ? 25736 - angle : angle;
+        res[j] = (yj < 0) ? -angle : angle;
+    }
+}
+
+int16_t fix15_atan2(int16_t y, int16_t x)
+{
+    int16_t res;
+    fix15_atan2_array(&y, &x, &res, 1);
+    return res;
+}
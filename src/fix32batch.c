@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32batch.h"
+
+
+// loop annotation for OpenMP SIMD (ignored unless enabled)
+#if defined(_OPENMP) || defined(FIX32_OPENMP_SIMD)
+#define FIX32_BATCH_SIMD    _Pragma("omp simd")
+#else
+#define FIX32_BATCH_SIMD
+#endif
+
+// product of a and b divided by 2^n, rounded like 'fix32_mul()'
+#define FIX32_BATCH_MUL(a, b, n) \
+    ((int32_t)FIX32_MATH_MUL_ROUND_FUNC((int64_t)(a) * (b), n))
+
+
+/**
+ * Index of the highest set bit (0 for 0), without branches
+ */
+static inline uint32_t fix32_batch_msb(uint32_t val)
+{
+    uint32_t msb, shift;
+    msb   = (uint32_t)(val > 0xFFFF) << 4;
+    val >>= msb;
+    shift = (uint32_t)(val > 0xFF) << 3;
+    msb  += shift;
+    val >>= shift;
+    shift = (uint32_t)(val > 0xF) << 2;
+    msb  += shift;
+    val >>= shift;
+    shift = (uint32_t)(val > 0x3) << 1;
+    msb  += shift;
+    val >>= shift;
+    return msb + (uint32_t)(val > 0x1);
+}
+
+/**
+ * Even index of the highest set bit, i.e. the index of the highest set bit or
+ * the index below it (0 for 0), without branches
+ */
+static inline uint32_t fix32_batch_msb_even(uint32_t val)
+{
+    return fix32_batch_msb(val) & ~1u;
+}
+
+
+void fix32_batch_mul(const int32_t *FIX32_RESTRICT a,
+                     const int32_t *FIX32_RESTRICT b,
+                     int32_t *FIX32_RESTRICT res, size_t count, int n)
+{
+    size_t i;
+    FIX32_BATCH_SIMD
+    for (i = 0; i < count; i++)
+        res[i] = FIX32_BATCH_MUL(a[i], b[i], n);
+}
+
+void fix32_batch_invsqrt(const uint32_t *FIX32_RESTRICT src,
+                         int32_t *FIX32_RESTRICT dst,
+                         int32_t *FIX32_RESTRICT res_scale, size_t count,
+                         int scale)
+{
+    int odd = scale & 1;
+    size_t i;
+    FIX32_BATCH_SIMD
+    for (i = 0; i < count; i++) {
+        uint32_t val = src[i];
+
+        // for an odd scale, double val (or halve it with rounding if its
+        // highest bit is set) and adjust the scale to be even
+        uint32_t top = val >> 31;
+        uint32_t val_even   = top ? (val >> 1) + (val & 1) : val << 1;
+        int32_t  scale_even = top ? scale - 1 : scale + 1;
+        val        = odd ? val_even : val;
+        scale_even = odd ? scale_even : scale;
+
+        // val = a * 2^(2n) with 1 <= a < 4 (a with a scaling factor of 2^30)
+        uint32_t msb_even = fix32_batch_msb_even(val);
+        uint32_t a = val << (30 - msb_even);
+        int32_t  n = ((int32_t)msb_even - scale_even) >> 1;
+
+        dst[i]       = (int32_t)fix32_invsqrt_norm(a);
+        res_scale[i] = 30 + n;
+    }
+}
+
+void fix32_batch_atan2(const int32_t *FIX32_RESTRICT y,
+                       const int32_t *FIX32_RESTRICT x,
+                       int32_t *FIX32_RESTRICT res, size_t count)
+{
+    const int32_t _28125  = 0x48000000, // 0.28125 with scaling factor 2^32
+                  pi_half = 0x1921FB54, // pi/2 with scaling factor 2^28
+                  pi      = 0x3243F6A9; // pi with scaling factor 2^28
+
+    size_t i;
+    FIX32_BATCH_SIMD
+    for (i = 0; i < count; i++) {
+        int32_t x_i = x[i], y_i = y[i];
+        uint32_t abs_x = (x_i >= 0) ? (uint32_t)x_i : -(uint32_t)x_i,
+                 abs_y = (y_i >= 0) ? (uint32_t)y_i : -(uint32_t)y_i;
+
+        // octants 1, 2, 5 and 6 (|y| >= |x|) swap the roles of x and y
+        int swap = abs_x <= abs_y;
+
+        // normalize the highest set bit of the larger magnitude to index 29
+        // (one of the two shifts is 0)
+        int32_t  msb    = (int32_t)fix32_batch_msb(abs_x | abs_y);
+        uint32_t shr    = (msb > 29) ? (uint32_t)(msb - 29) : 0,
+                 shl    = (msb > 29) ? 0 : (uint32_t)(29 - msb);
+        int32_t  norm_x = (int32_t)((uint32_t)(x_i >> shr) << shl),
+                 norm_y = (int32_t)((uint32_t)(y_i >> shr) << shl);
+
+        // products and squares with a scaling factor of 2^28
+        int32_t x_y  = FIX32_BATCH_MUL(norm_x, norm_y, 32),
+                sq_x = FIX32_BATCH_MUL(norm_x, norm_x, 32),
+                sq_y = FIX32_BATCH_MUL(norm_y, norm_y, 32);
+
+        // 0.25 <= denum < 1.28125 with a scaling factor of 2^28
+        int32_t sq_big   = swap ? sq_y : sq_x,
+                sq_small = swap ? sq_x : sq_y;
+        int32_t denum = sq_big + FIX32_BATCH_MUL(sq_small, _28125, 32);
+
+        // inverse square root of denum (scaling factor 2^28, which is even)
+        // with a scaling factor of 2^den_scale
+        uint32_t msb_even  = fix32_batch_msb_even((uint32_t)denum);
+        uint32_t a         = (uint32_t)denum << (30 - msb_even);
+        int32_t  den_scale = 30 + (((int32_t)msb_even - 28) >> 1);
+        int32_t  inv_sqrt  = (int32_t)fix32_invsqrt_norm(a);
+
+        // inverse with a scaling factor of 2^(2*den_scale - 32); the product
+        // x_y * inv is scaled to 2^28 by shifting right by 2*den_scale - 32,
+        // which is either 26 or 28 and thus equivalent to shifting it left
+        // by 28 - (2*den_scale - 32) bits first and then right by 28 bits
+        int32_t inv = FIX32_BATCH_MUL(inv_sqrt, inv_sqrt, 32);
+        uint32_t shift = (uint32_t)(60 - 2 * den_scale);
+        int64_t  prod  = (int64_t)((uint64_t)((int64_t)x_y * inv) << shift);
+        int32_t  ratio = (int32_t)FIX32_MATH_MUL_ROUND_FUNC(prod, 28);
+
+        // select the octant without branches
+        int32_t base = swap ? ((y_i < 0) ? -pi_half : pi_half)
+                            : ((x_i < 0) ? ((y_i < 0) ? -pi : pi) : 0);
+        int32_t angle = base + (swap ? -ratio : ratio);
+        res[i] = ((abs_x | abs_y) == 0) ? 0 : angle;
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32bfp.h"
+
+
+/**
+ * Index of the highest set bit of a 64-bit value; -1 for 0
+ */
+static int fix32_bfp_msb(uint64_t val)
+{
+    int msb = -1;
+    if (val >> 32) {
+        val >>= 32;
+        msb += 32;
+    }
+    if (val >> 16) {
+        val >>= 16;
+        msb += 16;
+    }
+    if (val >> 8) {
+        val >>= 8;
+        msb += 8;
+    }
+    if (val >> 4) {
+        val >>= 4;
+        msb += 4;
+    }
+    if (val >> 2) {
+        val >>= 2;
+        msb += 2;
+    }
+    if (val >> 1) {
+        val >>= 1;
+        msb += 1;
+    }
+    return msb + (int)val;
+}
+
+
+/**
+ * Scale a 64-bit value down by 2^shift with the rounding function of
+ * 'fix32_mul()', or up by 2^-shift if shift is negative
+ */
+static int32_t fix32_bfp_shift(int64_t val, int shift)
+{
+    if (shift <= 0)
+        return (int32_t)((uint64_t)val << -shift);
+    return FIX32_MATH_MUL_ROUND_FUNC(val, (shift < 63) ? shift : 63);
+}
+
+
+void fix32_bfp_init(fix32_bfp *bfp, int32_t *mant, size_t count, int scale)
+{
+    bfp->mant  = mant;
+    bfp->count = count;
+    bfp->scale = scale;
+}
+
+
+int fix32_bfp_headroom(const fix32_bfp *bfp)
+{
+    // OR of all magnitudes (ones' complement for negative mantissas, which
+    // has the same number of redundant sign bits)
+    uint32_t bits = 0;
+    size_t i;
+    for (i = 0; i < bfp->count; i++)
+        bits |= bfp->mant[i] ^ (bfp->mant[i] >> 31);
+    return 30 - fix32_bfp_msb(bits);
+}
+
+
+void fix32_bfp_normalize(fix32_bfp *bfp)
+{
+    int shift = fix32_bfp_headroom(bfp) - 1;
+    if (shift == 0)
+        return;
+
+    // a headroom of 31 means that all mantissas are 0 or -1; only the latter
+    // are shifted (to -2^30)
+    size_t i;
+    if (shift == 30) {
+        for (i = 0; i < bfp->count && bfp->mant[i] == 0; i++)
+            ;
+        if (i == bfp->count)
+            return;
+    }
+
+    // a headroom of 0 requires a right shift by 1, which rounds towards minus
+    // infinity in order to keep the positive mantissas below 2^30
+    for (i = 0; i < bfp->count; i++) {
+        int32_t m = bfp->mant[i];
+        bfp->mant[i] = (shift > 0) ? (int32_t)((uint32_t)m << shift) : m >> 1;
+    }
+    bfp->scale += shift;
+}
+
+
+void fix32_bfp_mul(const fix32_bfp *a, const fix32_bfp *b, fix32_bfp *res)
+{
+    // the magnitudes of the products are at most 2^(62 - head_a - head_b);
+    // scale them to at most 2^30
+    int shift = 32 - fix32_bfp_headroom(a) - fix32_bfp_headroom(b);
+    int scale = a->scale + b->scale - shift;
+
+    size_t i;
+    for (i = 0; i < a->count; i++) {
+        int64_t prod = (int64_t)a->mant[i] * b->mant[i];
+        res->mant[i] = fix32_bfp_shift(prod, shift);
+    }
+    res->scale = scale;
+
+    fix32_bfp_normalize(res);
+}
+
+
+void fix32_bfp_add(const fix32_bfp *a, const fix32_bfp *b, fix32_bfp *res)
+{
+    // common scale at which the magnitudes of both operands are at most 2^29,
+    // such that their sum is at most 2^30
+    int scale_a = a->scale + fix32_bfp_headroom(a),
+        scale_b = b->scale + fix32_bfp_headroom(b);
+    int scale = ((scale_a < scale_b) ? scale_a : scale_b) - 2;
+    int shift_a = a->scale - scale,
+        shift_b = b->scale - scale;
+
+    size_t i;
+    for (i = 0; i < a->count; i++)
+        res->mant[i] = fix32_bfp_shift(a->mant[i], shift_a) +
+                       fix32_bfp_shift(b->mant[i], shift_b);
+    res->scale = scale;
+
+    fix32_bfp_normalize(res);
+}
+
+
+void fix32_bfp_invsqrt(const fix32_bfp *src, fix32_bfp *res)
+{
+    // the mantissas are positive, hence they can be read as unsigned
+    res->scale = fix32_invsqrt_array_auto((const uint32_t *)src->mant,
+                                          res->mant, src->count, src->scale);
+    fix32_bfp_normalize(res);
+}
+
+
+void fix32_bfp_sqrt(const fix32_bfp *src, fix32_bfp *res)
+{
+    // sqrt(val) = val * invsqrt(val) ; the largest element yields the largest
+    // result, the scale of which is chosen such that it is below 2^30
+    int32_t max = 0;
+    size_t i;
+    for (i = 0; i < src->count; i++)
+        max = (src->mant[i] > max) ? src->mant[i] : max;
+
+    int scale = src->scale;
+    if (max > 0) {
+        int inv_scale = src->scale;
+        int64_t prod = (int64_t)max * fix32_invsqrt(max, &inv_scale);
+        scale += inv_scale - (fix32_bfp_msb(prod) - 29);
+    }
+
+    for (i = 0; i < src->count; i++) {
+        int32_t val = src->mant[i];
+        if (val == 0) {
+            res->mant[i] = 0;
+            continue;
+        }
+        int inv_scale = src->scale;
+        int64_t prod = (int64_t)val * fix32_invsqrt(val, &inv_scale);
+        res->mant[i] = fix32_bfp_shift(prod, src->scale + inv_scale - scale);
+    }
+    res->scale = scale;
+
+    fix32_bfp_normalize(res);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include <string.h>
+
+#include "fix32math.h"
+#include "fix32biquad.h"
+
+
+void fix32_biquad_init(fix32_biquad *bq, const fix32_biquad_coeffs *coeffs,
+                       fix32_biquad_state *state, size_t sections,
+                       fix32_biquad_form form, fix32_rounding rounding,
+                       int n)
+{
+    bq->coeffs   = coeffs;
+    bq->state    = state;
+    bq->sections = sections;
+    bq->form     = form;
+    bq->rounding = rounding;
+    bq->n        = n;
+    fix32_biquad_reset(bq);
+}
+
+void fix32_biquad_reset(fix32_biquad *bq)
+{
+    size_t i;
+    for (i = 0; i < bq->sections; i++) {
+        fix32_biquad_state *st = &bq->state[i];
+        st->x1  = st->x2 = st->y1 = st->y2 = 0;
+        st->err = 0;
+        st->s1  = st->s2 = 0;
+    }
+}
+
+
+/**
+ * Block kernel filtering a block with one Direct Form I section, rounding with
+ * 'fix32_scale_<ROUNDING>_64()' (see 'fix32base.h').  'ERR_UPDATE' is the
+ * statement computing the rounding error carried over to the next output
+ * sample; it is empty for the kernels without error feedback, whose 'err'
+ * thus remains 0.
+ */
+#define FIX32_BIQUAD_DF1_KERNEL(NAME, ROUNDING, ERR_UPDATE)                   \
+static void NAME(const fix32_biquad_coeffs *c, fix32_biquad_state *st,        \
+                 const int32_t *in, int32_t *out, size_t count, int n)        \
+{                                                                             \
+    int32_t b0 = c->b0, b1 = c->b1, b2 = c->b2, a1 = c->a1, a2 = c->a2;       \
+    int32_t x1 = st->x1, x2 = st->x2, y1 = st->y1, y2 = st->y2;               \
+    int64_t err = st->err;                                                    \
+                                                                              \
+    size_t i;                                                                 \
+    for (i = 0; i < count; i++) {                                             \
+        int32_t x = in[i];                                                    \
+                                                                              \
+        int64_t acc = err;                                                    \
+        acc = fix32_mac(acc, b0, x);                                          \
+        acc = fix32_mac(acc, b1, x1);                                         \
+        acc = fix32_mac(acc, b2, x2);                                         \
+        acc -= (int64_t)a1 * y1;                                              \
+        acc -= (int64_t)a2 * y2;                                              \
+                                                                              \
+        int32_t y = (int32_t)fix32_scale_##ROUNDING##_64(acc, n);             \
+        ERR_UPDATE                                                            \
+                                                                              \
+        x2 = x1;                                                              \
+        x1 = x;                                                               \
+        y2 = y1;                                                              \
+        y1 = y;                                                               \
+        out[i] = y;                                                           \
+    }                                                                         \
+                                                                              \
+    st->x1  = x1;                                                             \
+    st->x2  = x2;                                                             \
+    st->y1  = y1;                                                             \
+    st->y2  = y2;                                                             \
+    st->err = err;                                                            \
+}
+
+/**
+ * Block kernels of all structures for one rounding flavour:
+ *
+ *  - fix32_biquad_df1_<rounding>(): Direct Form I
+ *
+ *  - fix32_biquad_df1_ef_<rounding>(): Direct Form I with error feedback
+ *
+ *  - fix32_biquad_df2t_<rounding>(): Direct Form II transposed
+ *
+ * The structure and rounding flavour are selected once per block, such that
+ * the inner loops contain no dispatch.
+ */
+#define FIX32_BIQUAD_KERNELS(ROUNDING)                                        \
+FIX32_BIQUAD_DF1_KERNEL(fix32_biquad_df1_##ROUNDING, ROUNDING, )              \
+FIX32_BIQUAD_DF1_KERNEL(fix32_biquad_df1_ef_##ROUNDING, ROUNDING,             \
+                        err = acc - (int64_t)y * (1LL << n);)                 \
+                                                                              \
+static void fix32_biquad_df2t_##ROUNDING (const fix32_biquad_coeffs *c,       \
+                                          fix32_biquad_state *st,             \
+                                          const int32_t *in, int32_t *out,    \
+                                          size_t count, int n)                \
+{                                                                             \
+    int32_t b0 = c->b0, b1 = c->b1, b2 = c->b2, a1 = c->a1, a2 = c->a2;       \
+    int64_t s1 = st->s1, s2 = st->s2;                                         \
+                                                                              \
+    size_t i;                                                                 \
+    for (i = 0; i < count; i++) {                                             \
+        int32_t x = in[i];                                                    \
+        int64_t acc = fix32_mac(s1, b0, x);                                   \
+        int32_t y   = (int32_t)fix32_scale_##ROUNDING##_64(acc, n);           \
+                                                                              \
+        s1 = fix32_mac(s2, b1, x) - (int64_t)a1 * y;                          \
+        s2 = (int64_t)b2 * x - (int64_t)a2 * y;                               \
+        out[i] = y;                                                           \
+    }                                                                         \
+                                                                              \
+    st->s1 = s1;                                                              \
+    st->s2 = s2;                                                              \
+}
+FIX32_BIQUAD_KERNELS(rhu)
+FIX32_BIQUAD_KERNELS(rhd)
+FIX32_BIQUAD_KERNELS(rhaz)
+FIX32_BIQUAD_KERNELS(rhtz)
+
+
+// kernels indexed by the structure (in the order of 'fix32_biquad_form') and
+// the rounding flavour (in the order of 'fix32_rounding')
+typedef void (*fix32_biquad_kernel)(const fix32_biquad_coeffs *c,
+                                    fix32_biquad_state *st,
+                                    const int32_t *in, int32_t *out,
+                                    size_t count, int n);
+
+static const fix32_biquad_kernel fix32_biquad_kernels[][4] = {
+    {
+        fix32_biquad_df1_rhu, fix32_biquad_df1_rhd,
+        fix32_biquad_df1_rhaz, fix32_biquad_df1_rhtz
+    }, {
+        fix32_biquad_df1_ef_rhu, fix32_biquad_df1_ef_rhd,
+        fix32_biquad_df1_ef_rhaz, fix32_biquad_df1_ef_rhtz
+    }, {
+        fix32_biquad_df2t_rhu, fix32_biquad_df2t_rhd,
+        fix32_biquad_df2t_rhaz, fix32_biquad_df2t_rhtz
+    }
+};
+
+
+void fix32_biquad_process(fix32_biquad *bq, const int32_t *in, int32_t *out,
+                          size_t count)
+{
+    fix32_biquad_kernel kernel = fix32_biquad_kernels[bq->form][bq->rounding];
+
+    // an empty cascade passes the input through unchanged
+    if (bq->sections == 0) {
+        if (in != out)
+            memmove(out, in, count * sizeof(int32_t));
+        return;
+    }
+
+    // the first section reads the input, all others filter the output of the
+    // preceding section in place
+    size_t i;
+    for (i = 0; i < bq->sections; i++) {
+        const int32_t *src = (i == 0) ? in : out;
+        kernel(&bq->coeffs[i], &bq->state[i], src, out, count, bq->n);
+    }
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32cmplx.h"
+
+
+fix32_cmplx fix32_cmplx_mul(fix32_cmplx a, fix32_cmplx b, int n)
+{
+    fix32_cmplx res;
+    res.re = fix32_acc_scale((int64_t)a.re * b.re - (int64_t)a.im * b.im, n);
+    res.im = fix32_acc_scale((int64_t)a.re * b.im + (int64_t)a.im * b.re, n);
+    return res;
+}
+
+
+fix32_cmplx fix32_cmplx_mul_gauss(fix32_cmplx a, fix32_cmplx b, int n)
+{
+    // k1 = b.re * (a.re + a.im)
+    // k2 = a.re * (b.im - b.re)
+    // k3 = a.im * (b.re + b.im)
+    // then: re = k1 - k3 and im = k1 + k2
+    int64_t k1 = b.re * ((int64_t)a.re + a.im),
+            k2 = a.re * ((int64_t)b.im - b.re),
+            k3 = a.im * ((int64_t)b.re + b.im);
+
+    fix32_cmplx res;
+    res.re = fix32_acc_scale(k1 - k3, n);
+    res.im = fix32_acc_scale(k1 + k2, n);
+    return res;
+}
+
+
+fix32_cmplx fix32_cmplx_mul_conj(fix32_cmplx a, fix32_cmplx b, int n)
+{
+    fix32_cmplx res;
+    res.re = fix32_acc_scale((int64_t)a.re * b.re + (int64_t)a.im * b.im, n);
+    res.im = fix32_acc_scale((int64_t)a.im * b.re - (int64_t)a.re * b.im, n);
+    return res;
+}
+
+
+int32_t fix32_cmplx_mag(fix32_cmplx a)
+{
+    int64_t re = a.re, im = a.im;
+    uint64_t sq = (uint64_t)(re * re) + (uint64_t)(im * im);
+    if (sq == 0)
+        return 0;
+
+    // reduce the squared magnitude to 32 bits by an even shift
+    uint32_t hi = sq >> 32;
+    int shift = 0;
+    while (shift < 32 && (hi >> shift) != 0)
+        shift += 2;
+    uint32_t sq_32 = sq >> shift;
+
+    // |a| = |a|^2 / sqrt(|a|^2) ; the values are treated as integers, thus
+    // the squared magnitude has a scaling factor of 2^-shift and the product
+    // with its inverse square root is shifted by scale - shift
+    int scale = -shift;
+    uint32_t inv = fix32_invsqrt(sq_32, &scale);
+    return FIX32_MATH_MUL_ROUND_FUNC((int64_t)((uint64_t)sq_32 * inv),
+                                     scale - shift);
+}
+
+
+/**
+ * Index of the highest set bit of a non-zero value
+ */
+static int fix32_cmplx_msb(uint64_t val)
+{
+    int msb = 0;
+    if (val >> 32) {
+        val >>= 32;
+        msb += 32;
+    }
+    if (val >> 16) {
+        val >>= 16;
+        msb += 16;
+    }
+    if (val >> 8) {
+        val >>= 8;
+        msb += 8;
+    }
+    if (val >> 4) {
+        val >>= 4;
+        msb += 4;
+    }
+    if (val >> 2) {
+        val >>= 2;
+        msb += 2;
+    }
+    if (val >> 1)
+        msb += 1;
+    return msb;
+}
+
+/**
+ * Phase of a complex number with 64-bit real and imaginary parts
+ */
+static int32_t fix32_cmplx_phase_64(int64_t re, int64_t im)
+{
+    // fix32_atan2 takes 32-bit arguments; since the phase does not depend on
+    // the magnitude, scale both parts such that the larger one has its
+    // highest set bit at index 29 (the range fix32_atan2 normalizes to)
+    uint64_t mag_or = ((re < 0) ? -(uint64_t)re : (uint64_t)re)
+                    | ((im < 0) ? -(uint64_t)im : (uint64_t)im);
+    if (mag_or == 0)
+        return 0;
+
+    int shift = fix32_cmplx_msb(mag_or) - 29;
+    if (shift > 0) {
+        re >>= shift;
+        im >>= shift;
+    } else {
+        re *= 1LL << -shift;
+        im *= 1LL << -shift;
+    }
+    return fix32_atan2(im, re, 0);
+}
+
+int32_t fix32_cmplx_phase(fix32_cmplx a)
+{
+    // fix32_atan2 normalizes 32-bit arguments the same way by itself
+    return fix32_atan2(a.im, a.re, 0);
+}
+
+
+void fix32_cmplx_mul_array(const fix32_cmplx *a, const fix32_cmplx *b,
+                           fix32_cmplx *res, size_t count, int n)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        res[i] = fix32_cmplx_mul(a[i], b[i], n);
+}
+
+void fix32_cmplx_mul_conj_array(const fix32_cmplx *a, const fix32_cmplx *b,
+                                fix32_cmplx *res, size_t count, int n)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        res[i] = fix32_cmplx_mul_conj(a[i], b[i], n);
+}
+
+void fix32_cmplx_mag_array(const fix32_cmplx *a, int32_t *mag, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        mag[i] = fix32_cmplx_mag(a[i]);
+}
+
+void fix32_cmplx_phase_array(const fix32_cmplx *a, int32_t *phase,
+                             size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        phase[i] = fix32_cmplx_phase(a[i]);
+}
+
+
+void fix32_cmplx_disc_init(fix32_cmplx_disc *disc)
+{
+    disc->prev.re = 0;
+    disc->prev.im = 0;
+}
+
+void fix32_cmplx_disc_process(fix32_cmplx_disc *disc, const fix32_cmplx *in,
+                              int32_t *out, size_t count)
+{
+    fix32_cmplx prev = disc->prev;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        fix32_cmplx cur = in[i];
+
+        // s[i] * conj(s[i-1]) in full 64-bit precision; the real part reaches
+        // 2^63 if all four parts are INT32_MIN, hence it is summed modulo 2^64
+        // and that single value saturated (the imaginary part is then 0)
+        uint64_t re_u = (uint64_t)((int64_t)cur.re * prev.re)
+                      + (uint64_t)((int64_t)cur.im * prev.im);
+        int64_t re = (re_u == (uint64_t)1 << 63) ? INT64_MAX : (int64_t)re_u,
+                im = (int64_t)cur.im * prev.re - (int64_t)cur.re * prev.im;
+
+        out[i] = fix32_cmplx_phase_64(re, im);
+        prev = cur;
+    }
+    disc->prev = prev;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32conv.h"
+
+
+/**
+ * 2^n as double (exact for -1022 <= n <= 1023)
+ */
+static double fix32_conv_pow2(int n)
+{
+    double res = 1.;
+    for (; n > 0; n--)
+        res *= 2.;
+    for (; n < 0; n++)
+        res *= .5;
+    return res;
+}
+
+
+/**
+ * Round a scaled value to the nearest integer and saturate it to 32 bits;
+ * ties are rounded up for non-negative values if 'half_up_pos' is set and
+ * for negative values if 'half_up_neg' is set (and down otherwise)
+ */
+static int32_t fix32_conv_round(double val, int half_up_pos, int half_up_neg)
+{
+    // NaN becomes 0; values out of range are clamped to the 32-bit range,
+    // which yields the saturated result after rounding as well
+    val = (val == val) ? val : 0.;
+    val = (val < -2147483648.) ? -2147483648. : val;
+    val = (val >  2147483647.) ?  2147483647. : val;
+
+    // integer part (rounded towards minus infinity) and the fraction, which
+    // is exact in the range above
+    int32_t res = (int32_t)val;
+    res -= ((double)res > val);
+    double frac = val - (double)res;
+
+    // rounding up cannot overflow, since the fraction of 2147483647 is 0
+    int half_up = (val >= 0.) ? half_up_pos : half_up_neg;
+    res += (frac > .5) | ((frac == .5) & half_up);
+    return res;
+}
+
+
+/**
+ * Rounding direction of ties for non-negative and negative values
+ */
+static void fix32_conv_half_up(fix32_rounding rounding, int *pos, int *neg)
+{
+    *pos = (rounding == FIX32_RHU) || (rounding == FIX32_RHAZ);
+    *neg = (rounding == FIX32_RHU) || (rounding == FIX32_RHTZ);
+}
+
+
+void fix32_from_float(const float *src, int32_t *dst, size_t count, int scale,
+                      fix32_rounding rounding)
+{
+    // the product of a float and a power of 2 is exact as double
+    double factor = fix32_conv_pow2(scale);
+    int pos, neg;
+    fix32_conv_half_up(rounding, &pos, &neg);
+
+    size_t i;
+    for (i = 0; i < count; i++)
+        dst[i] = fix32_conv_round((double)src[i] * factor, pos, neg);
+}
+
+void fix32_from_double(const double *src, int32_t *dst, size_t count,
+                       int scale, fix32_rounding rounding)
+{
+    double factor = fix32_conv_pow2(scale);
+    int pos, neg;
+    fix32_conv_half_up(rounding, &pos, &neg);
+
+    size_t i;
+    for (i = 0; i < count; i++)
+        dst[i] = fix32_conv_round(src[i] * factor, pos, neg);
+}
+
+
+void fix32_to_float(const int32_t *src, float *dst, size_t count, int scale)
+{
+    // the conversion to double and the scaling are exact, hence the result is
+    // rounded only once
+    double factor = fix32_conv_pow2(-scale);
+    size_t i;
+    for (i = 0; i < count; i++)
+        dst[i] = (float)((double)src[i] * factor);
+}
+
+void fix32_to_double(const int32_t *src, double *dst, size_t count,
+                     int scale)
+{
+    double factor = fix32_conv_pow2(-scale);
+    size_t i;
+    for (i = 0; i < count; i++)
+        dst[i] = (double)src[i] * factor;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32cmplx.h"
+#include "fix32fft.h"
+#include "fix32sintab.h"
+
+
+#define FIX32_SINTAB_QUARTER    (1 << (FIX32_SINTAB_BITS - 2))
+
+/**
+ * Sine of 2 pi idx / 2^FIX32_SINTAB_BITS with a scaling factor of 2^30
+ */
+static int32_t fix32_fft_sin(uint32_t idx)
+{
+    uint32_t quadrant = (idx >> (FIX32_SINTAB_BITS - 2)) & 3,
+             offset   = idx & (FIX32_SINTAB_QUARTER - 1);
+    if (quadrant & 1)
+        offset = FIX32_SINTAB_QUARTER - offset;
+    return (quadrant & 2) ? -fix32_sintab[offset] : fix32_sintab[offset];
+}
+
+
+/**
+ * In-place FFT of 2^log2n complex values; element j is stored at
+ * re[j * stride] and im[j * stride]
+ */
+static int fix32_fft_core(int32_t *re, int32_t *im, ptrdiff_t stride,
+                          int log2n, int inverse)
+{
+    if (log2n < 0 || log2n > FIX32_SINTAB_BITS)
+        return -1;
+
+    size_t size = (size_t)1 << log2n, i, j;
+
+    // bit-reversal permutation
+    for (i = 0, j = 0; i < size; i++) {
+        if (i < j) {
+            int32_t tmp_re = re[i * stride], tmp_im = im[i * stride];
+            re[i * stride] = re[j * stride];
+            im[i * stride] = im[j * stride];
+            re[j * stride] = tmp_re;
+            im[j * stride] = tmp_im;
+        }
+        size_t bit = size >> 1;
+        while (bit != 0 && (j & bit)) {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+
+    // Bitwise OR of the magnitudes of all values, which is used to detect
+    // values that might overflow; negative values v contribute -v - 1 (which
+    // is cheaper to obtain and sufficient for the overflow condition below).
+    uint32_t mag_or = 0;
+    for (i = 0; i < size; i++) {
+        mag_or |= (uint32_t)(re[i * stride] ^ (re[i * stride] >> 31));
+        mag_or |= (uint32_t)(im[i * stride] ^ (im[i * stride] >> 31));
+    }
+
+    int exponent = 0, stage;
+    for (stage = 1; stage <= log2n; stage++) {
+        size_t len = (size_t)1 << stage, half = len >> 1;
+
+        // A butterfly output component is at most (1 + sqrt(2)) times the
+        // magnitude of the largest input component; as long as inputs stay
+        // below 2^29, outputs stay below 2^31.  Otherwise halve the outputs
+        // for inputs below 2^30 and quarter them for larger inputs (halving
+        // alone would still let outputs reach (1 + sqrt(2)) / 2 * 2^31).
+        int shift = 30;
+        if (mag_or >= (1u << 30)) {
+            shift += 2;
+            exponent += 2;
+        } else if (mag_or >= (1u << 29)) {
+            shift++;
+            exponent++;
+        }
+        mag_or = 0;
+
+        for (j = 0; j < half; j++) {
+            // twiddle factor exp(-/+ 2 pi i j / len) with a scaling factor of
+            // 2^30
+            uint32_t idx = j << (FIX32_SINTAB_BITS - stage);
+            int32_t w_re = fix32_fft_sin(idx + FIX32_SINTAB_QUARTER),
+                    w_im = fix32_fft_sin(idx);
+            if (!inverse)
+                w_im = -w_im;
+
+            for (i = j; i < size; i += len) {
+                int32_t *a_re = &re[i * stride], *a_im = &im[i * stride],
+                        *b_re = &re[(i + half) * stride],
+                        *b_im = &im[(i + half) * stride];
+
+                // a * 2^30 and w * b with a scaling factor of 2^30
+                int64_t a_re_ext = (int64_t)*a_re * (1 << 30),
+                        a_im_ext = (int64_t)*a_im * (1 << 30),
+                        t_re = (int64_t)w_re * *b_re - (int64_t)w_im * *b_im,
+                        t_im = (int64_t)w_re * *b_im + (int64_t)w_im * *b_re;
+
+                *a_re = FIX32_MATH_MUL_ROUND_FUNC(a_re_ext + t_re, shift);
+                *a_im = FIX32_MATH_MUL_ROUND_FUNC(a_im_ext + t_im, shift);
+                *b_re = FIX32_MATH_MUL_ROUND_FUNC(a_re_ext - t_re, shift);
+                *b_im = FIX32_MATH_MUL_ROUND_FUNC(a_im_ext - t_im, shift);
+
+                mag_or |= (uint32_t)(*a_re ^ (*a_re >> 31))
+                        | (uint32_t)(*a_im ^ (*a_im >> 31))
+                        | (uint32_t)(*b_re ^ (*b_re >> 31))
+                        | (uint32_t)(*b_im ^ (*b_im >> 31));
+            }
+        }
+    }
+    return exponent;
+}
+
+
+int fix32_fft(int32_t *buf, int log2n)
+{
+    return fix32_fft_core(buf, buf + 1, 2, log2n, 0);
+}
+
+int fix32_fft_split(int32_t *re, int32_t *im, int log2n)
+{
+    return fix32_fft_core(re, im, 1, log2n, 0);
+}
+
+int fix32_ifft(int32_t *buf, int log2n)
+{
+    return fix32_fft_core(buf, buf + 1, 2, log2n, 1);
+}
+
+int fix32_ifft_split(int32_t *re, int32_t *im, int log2n)
+{
+    return fix32_fft_core(re, im, 1, log2n, 1);
+}
+
+
+void fix32_fft_magnitude(const int32_t *buf, int32_t *mag, size_t count)
+{
+    fix32_cmplx_mag_array((const fix32_cmplx *)buf, mag, count);
+}
+
+void fix32_fft_phase(const int32_t *buf, int32_t *phase, size_t count)
+{
+    fix32_cmplx_phase_array((const fix32_cmplx *)buf, phase, count);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32fir.h"
+
+
+int fix32_fir_init(fix32_fir *fir, const int32_t *coeffs, size_t taps,
+                   int32_t *delay, int n)
+{
+    // the delay line indexing requires at least one tap
+    if (taps == 0)
+        return -1;
+
+    fir->coeffs = coeffs;
+    fir->delay  = delay;
+    fir->taps   = taps;
+    fir->n      = n;
+    fix32_fir_reset(fir);
+    return 0;
+}
+
+void fix32_fir_reset(fix32_fir *fir)
+{
+    size_t i;
+    for (i = 0; i < 2 * fir->taps; i++)
+        fir->delay[i] = 0;
+    fir->pos   = 0;
+    fir->phase = 0;
+}
+
+
+/**
+ * Insert a sample into the delay line; the window of the most recent samples
+ * starts at delay[pos] afterwards
+ */
+static void fix32_fir_push(fix32_fir *fir, int32_t sample)
+{
+    size_t pos = (fir->pos == 0 ? fir->taps : fir->pos) - 1;
+    fir->delay[pos]             = sample;
+    fir->delay[pos + fir->taps] = sample;
+    fir->pos = pos;
+}
+
+
+void fix32_fir_process(fix32_fir *fir, const int32_t *in, int32_t *out,
+                       size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        fix32_fir_push(fir, in[i]);
+        out[i] = fix32_dot(fir->coeffs, fir->delay + fir->pos, fir->taps,
+                           fir->n);
+    }
+}
+
+
+size_t fix32_fir_decimate(fix32_fir *fir, const int32_t *in, int32_t *out,
+                          size_t count, size_t factor)
+{
+    size_t i, out_count = 0;
+
+    // the decimation phase would never reach a factor of 0
+    if (factor == 0)
+        return 0;
+
+    for (i = 0; i < count; i++) {
+        fix32_fir_push(fir, in[i]);
+        if (++fir->phase == factor) {
+            fir->phase = 0;
+            out[out_count++] = fix32_dot(fir->coeffs, fir->delay + fir->pos,
+                                         fir->taps, fir->n);
+        }
+    }
+    return out_count;
+}
+
+
+void fix32_fir_interpolate(fix32_fir *fir, const int32_t *in, int32_t *out,
+                           size_t count, size_t factor)
+{
+    size_t i, p;
+    for (i = 0; i < count; i++) {
+        fix32_fir_push(fir, in[i]);
+
+        // phase p uses the coefficients p, p + factor, p + 2 * factor, ...
+        for (p = 0; p < factor; p++) {
+            size_t phase_taps = (p < fir->taps)
+                              ? (fir->taps - p + factor - 1) / factor : 0;
+            *out++ = fix32_dot_strided(fir->coeffs + p, factor,
+                                       fir->delay + fir->pos, 1,
+                                       phase_taps, fir->n);
+        }
+    }
+}
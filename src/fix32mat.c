@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32mat.h"
+
+
+/**
+ * Multiply two matrices of size dim x dim; called with constant 'dim' only
+ */
+static void fix32_mat_mul(const int32_t *a, const int32_t *b, int32_t *res,
+                          int dim, int n)
+{
+    int32_t tmp[16];
+    int i, j, k;
+    for (i = 0; i < dim; i++) {
+        for (j = 0; j < dim; j++) {
+            int64_t acc = 0;
+            for (k = 0; k < dim; k++)
+                acc += (int64_t)a[i * dim + k] * b[k * dim + j];
+            tmp[i * dim + j] = FIX32_MATH_MUL_ROUND_FUNC(acc, n);
+        }
+    }
+    for (i = 0; i < dim * dim; i++)
+        res[i] = tmp[i];
+}
+
+void fix32_mat2_mul(const int32_t a[4], const int32_t b[4], int32_t res[4],
+                    int n)
+{
+    fix32_mat_mul(a, b, res, 2, n);
+}
+
+void fix32_mat3_mul(const int32_t a[9], const int32_t b[9], int32_t res[9],
+                    int n)
+{
+    fix32_mat_mul(a, b, res, 3, n);
+}
+
+void fix32_mat4_mul(const int32_t a[16], const int32_t b[16], int32_t res[16],
+                    int n)
+{
+    fix32_mat_mul(a, b, res, 4, n);
+}
+
+
+/**
+ * Transpose a matrix of size dim x dim in place or out of place
+ */
+static void fix32_mat_transpose(const int32_t *a, int32_t *res, int dim)
+{
+    int i, j;
+    for (i = 0; i < dim; i++) {
+        res[i * dim + i] = a[i * dim + i];
+        for (j = i + 1; j < dim; j++) {
+            int32_t upper = a[i * dim + j];
+            res[i * dim + j] = a[j * dim + i];
+            res[j * dim + i] = upper;
+        }
+    }
+}
+
+void fix32_mat2_transpose(const int32_t a[4], int32_t res[4])
+{
+    fix32_mat_transpose(a, res, 2);
+}
+
+void fix32_mat3_transpose(const int32_t a[9], int32_t res[9])
+{
+    fix32_mat_transpose(a, res, 3);
+}
+
+void fix32_mat4_transpose(const int32_t a[16], int32_t res[16])
+{
+    fix32_mat_transpose(a, res, 4);
+}
+
+
+/**
+ * Divide the elements of the adjugate matrix 'adj' (with scaling factor 2^n)
+ * by the determinant 'det' (with scaling factor 2^(2n)) and store the result
+ * in 'res'; returns -1 if det is 0 or if the result overflows
+ */
+static int fix32_mat_div_det(const int32_t *adj, int64_t det, int32_t *res,
+                             int size, int n)
+{
+    if (det == 0)
+        return -1;
+
+    // reduce the determinant to 32 bits
+    int det_scale = n + n;
+    while (det != (int32_t)det) {
+        det >>= 1;
+        det_scale--;
+    }
+
+    // reciprocal of the determinant with a scaling factor of 2^rec_scale;
+    // the product of an element of adj and the reciprocal has a scaling
+    // factor of 2^(n + rec_scale), i.e. it must be shifted by rec_scale
+    int rec_scale = det_scale;
+    int32_t rec = fix32_recip(det, &rec_scale);
+    if (rec_scale < 1)
+        return -1;
+
+    // the product is below 2^62 in magnitude, hence all elements round to 0
+    // for larger shifts (which must be avoided as they are undefined)
+    int i;
+    if (rec_scale > 62) {
+        for (i = 0; i < size; i++)
+            res[i] = 0;
+        return 0;
+    }
+
+    for (i = 0; i < size; i++) {
+        int64_t elem = FIX32_MATH_MUL_ROUND_FUNC((int64_t)adj[i] * rec,
+                                                 rec_scale);
+        if (elem != (int32_t)elem)
+            return -1;
+        res[i] = elem;
+    }
+    return 0;
+}
+
+
+int fix32_mat2_inverse(const int32_t a[4], int32_t res[4], int n)
+{
+    int64_t det = (int64_t)a[0] * a[3] - (int64_t)a[1] * a[2];
+    int32_t adj[4] = { a[3], -a[1], -a[2], a[0] };
+    return fix32_mat_div_det(adj, det, res, 4, n);
+}
+
+
+int fix32_mat3_inverse(const int32_t a[9], int32_t res[9], int n)
+{
+    // adjugate matrix (i.e., transposed cofactor matrix); the cofactors have
+    // a scaling factor of 2^(2n) and are rounded to a scaling factor of 2^n
+    int64_t cof[9] = {
+        (int64_t)a[4] * a[8] - (int64_t)a[5] * a[7],
+        (int64_t)a[2] * a[7] - (int64_t)a[1] * a[8],
+        (int64_t)a[1] * a[5] - (int64_t)a[2] * a[4],
+        (int64_t)a[5] * a[6] - (int64_t)a[3] * a[8],
+        (int64_t)a[0] * a[8] - (int64_t)a[2] * a[6],
+        (int64_t)a[2] * a[3] - (int64_t)a[0] * a[5],
+        (int64_t)a[3] * a[7] - (int64_t)a[4] * a[6],
+        (int64_t)a[1] * a[6] - (int64_t)a[0] * a[7],
+        (int64_t)a[0] * a[4] - (int64_t)a[1] * a[3]
+    };
+    int32_t adj[9];
+    int i;
+    for (i = 0; i < 9; i++) {
+        int64_t elem = FIX32_MATH_MUL_ROUND_FUNC(cof[i], n);
+        if (elem != (int32_t)elem)
+            return -1;
+        adj[i] = elem;
+    }
+
+    // determinant (expansion along the first row) with a scaling factor of
+    // 2^(2n)
+    int64_t det = (int64_t)a[0] * adj[0] + (int64_t)a[1] * adj[3]
+                + (int64_t)a[2] * adj[6];
+
+    return fix32_mat_div_det(adj, det, res, 9, n);
+}
+
+
+/**
+ * Transform 'count' vectors with 'dim' components by a matrix of size
+ * dim x dim; if 'affine' is set, the vectors have dim - 1 components and are
+ * extended by 1, and only the first dim - 1 rows of the matrix are used.
+ * Called with constant 'dim' and 'affine' only, such that the compiler can
+ * unroll the inner loops.
+ */
+static void fix32_mat_transform(const int32_t *m, const int32_t *src,
+                                int32_t *dst, size_t count, int dim,
+                                int affine, int n)
+{
+    int comp = affine ? dim - 1 : dim;
+    size_t i;
+    int j, k;
+    for (i = 0; i < count; i++) {
+        const int32_t *v = src + i * comp;
+        int32_t tmp[4];
+        for (j = 0; j < comp; j++) {
+            int64_t acc = 0;
+            for (k = 0; k < comp; k++)
+                acc += (int64_t)m[j * dim + k] * v[k];
+            if (affine)
+                acc += (int64_t)m[j * dim + comp] * (1LL << n);
+            tmp[j] = FIX32_MATH_MUL_ROUND_FUNC(acc, n);
+        }
+        for (j = 0; j < comp; j++)
+            dst[i * comp + j] = tmp[j];
+    }
+}
+
+void fix32_mat2_transform(const int32_t m[4], const int32_t *src, int32_t *dst,
+                          size_t count, int n)
+{
+    fix32_mat_transform(m, src, dst, count, 2, 0, n);
+}
+
+void fix32_mat3_transform(const int32_t m[9], const int32_t *src, int32_t *dst,
+                          size_t count, int n)
+{
+    fix32_mat_transform(m, src, dst, count, 3, 0, n);
+}
+
+void fix32_mat4_transform(const int32_t m[16], const int32_t *src,
+                          int32_t *dst, size_t count, int n)
+{
+    fix32_mat_transform(m, src, dst, count, 4, 0, n);
+}
+
+void fix32_mat4_transform_points(const int32_t m[16], const int32_t *src,
+                                 int32_t *dst, size_t count, int n)
+{
+    fix32_mat_transform(m, src, dst, count, 4, 1, n);
+}
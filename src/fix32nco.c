@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32nco.h"
+#include "fix32sintab.h"
+
+
+uint32_t fix32_rad_to_turn(int32_t rad)
+{
+    // turn = rad / (2 pi) * 2^32 / 2^28 = rad * 8/pi
+    const int64_t _8_pi = 0xA2F9836E; // 8/pi with a scaling factor of 2^30
+    return (uint32_t)FIX32_MATH_MUL_ROUND_FUNC(rad * _8_pi, 30);
+}
+
+int32_t fix32_turn_to_rad(uint32_t turn)
+{
+    // rad = turn * 2 pi / 2^32 * 2^28 = turn * pi/8 , with turn interpreted
+    // as a signed value in the interval [-2^31, 2^31)
+    const int64_t pi_8 = 0x6487ED51; // pi/8 with a scaling factor of 2^32
+    return FIX32_MATH_MUL_ROUND_FUNC((int32_t)turn * pi_8, 32);
+}
+
+
+/**
+ * Sine of a phase in turns with linear interpolation of the sine table
+ */
+static int32_t fix32_sin_turn(uint32_t turn)
+{
+    // bits of the offset within a quadrant, the upper of which index the
+    // table; the lower ones are the fraction between two table entries
+    const int frac_bits = 32 - FIX32_SINTAB_BITS;
+
+    uint32_t quadrant = turn >> 30,
+             offset   = turn & 0x3FFFFFFF;
+    if (quadrant & 1)
+        offset = 0x40000000 - offset; // 0 < offset <= 2^30
+
+    uint32_t idx  = offset >> frac_bits,
+             frac = offset & ((1u << frac_bits) - 1);
+    int32_t lower = fix32_sintab[idx],
+            upper = fix32_sintab[idx + 1];
+    int32_t res = lower + FIX32_MATH_MUL_ROUND_FUNC(
+                              (int64_t)(upper - lower) * frac, frac_bits);
+
+    return (quadrant & 2) ? -res : res;
+}
+
+void fix32_sincos_turn(uint32_t turn, int32_t *sin_val, int32_t *cos_val)
+{
+    *sin_val = fix32_sin_turn(turn);
+    *cos_val = fix32_sin_turn(turn + 0x40000000);
+}
+
+
+void fix32_nco_init(fix32_nco *nco, uint32_t freq, uint32_t phase)
+{
+    nco->freq  = freq;
+    nco->phase = phase;
+}
+
+void fix32_nco_process(fix32_nco *nco, fix32_cmplx *out, size_t count)
+{
+    uint32_t phase = nco->phase, freq = nco->freq;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        out[i].re = fix32_sin_turn(phase + 0x40000000);
+        out[i].im = fix32_sin_turn(phase);
+        phase += freq;
+    }
+    nco->phase = phase;
+}
+
+
+void fix32_unwrap_init(fix32_unwrap *unwrap)
+{
+    unwrap->prev = 0;
+    unwrap->acc  = 0;
+}
+
+void fix32_unwrap_process(fix32_unwrap *unwrap, const int32_t *in,
+                          int64_t *out, size_t count)
+{
+    const int32_t pi     = 0x3243F6A9, // pi with a scaling factor of 2^28
+                  two_pi = 0x6487ED51; // 2 pi with a scaling factor of 2^28
+
+    int32_t prev = unwrap->prev;
+    int64_t acc  = unwrap->acc;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        // the difference of two wrapped phases is at most 2 pi in magnitude
+        int32_t diff = in[i] - prev;
+        if (diff > pi)
+            diff -= two_pi;
+        else if (diff < -pi)
+            diff += two_pi;
+
+        acc += diff;
+        out[i] = acc;
+        prev = in[i];
+    }
+    unwrap->prev = prev;
+    unwrap->acc  = acc;
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fix32math.h"
+#include "fix32cmplx.h"
+#include "fix32conv.h"
+#include "fix32par.h"
+
+
+// state of the thread pool; a batch is started by incrementing 'gen' and
+// waking up the workers, which each decrement 'pending' when done
+static struct {
+    pthread_mutex_t call;       // serializes calls of fix32_par_for()
+    pthread_mutex_t lock;
+    pthread_cond_t start, done;
+    pthread_t *ids;
+    unsigned threads;
+    unsigned long gen;
+    unsigned pending;
+    int quit;
+
+    // current batch
+    size_t count, chunk;
+    fix32_par_kernel kernel;
+    void *ctx;
+} fix32_par_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    NULL, 1, 0, 0, 0, 0, 0, NULL, NULL
+};
+
+
+/**
+ * Process the range of the current batch assigned to thread 'index'
+ */
+static void fix32_par_range(unsigned index)
+{
+    size_t count = fix32_par_pool.count, chunk = fix32_par_pool.chunk;
+    unsigned threads = fix32_par_pool.threads;
+
+    size_t base = count / threads, rem = count % threads;
+    size_t beg = index * base + ((index < rem) ? index : rem),
+           end = beg + base + (index < rem);
+    chunk = (chunk == 0) ? end - beg : chunk;
+    for (; beg < end; beg += chunk) {
+        size_t len = end - beg;
+        fix32_par_pool.kernel(beg, beg + ((len < chunk) ? len : chunk),
+                              fix32_par_pool.ctx);
+    }
+}
+
+/**
+ * Main function of the worker threads; the argument is the thread index
+ */
+static void *fix32_par_worker(void *arg)
+{
+    unsigned index = (unsigned)(size_t)arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&fix32_par_pool.lock);
+    for (;;) {
+        while (fix32_par_pool.gen == seen && !fix32_par_pool.quit)
+            pthread_cond_wait(&fix32_par_pool.start, &fix32_par_pool.lock);
+        if (fix32_par_pool.quit)
+            break;
+        seen = fix32_par_pool.gen;
+
+        // the batch parameters do not change until all threads are done
+        pthread_mutex_unlock(&fix32_par_pool.lock);
+        fix32_par_range(index);
+        pthread_mutex_lock(&fix32_par_pool.lock);
+
+        if (--fix32_par_pool.pending == 0)
+            pthread_cond_signal(&fix32_par_pool.done);
+    }
+    pthread_mutex_unlock(&fix32_par_pool.lock);
+    return NULL;
+}
+
+
+int fix32_par_init(unsigned threads)
+{
+    fix32_par_shutdown();
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (unsigned)online : 1;
+    }
+    if (threads == 1)
+        return 1;
+
+    pthread_mutex_lock(&fix32_par_pool.call);
+    fix32_par_pool.ids = malloc((threads - 1) * sizeof(pthread_t));
+    int res = (fix32_par_pool.ids == NULL) ? -1 : (int)threads;
+
+    // the calling thread has index 0
+    unsigned i;
+    for (i = 1; res > 0 && i < threads; i++) {
+        if (pthread_create(&fix32_par_pool.ids[i - 1], NULL, fix32_par_worker,
+                           (void *)(size_t)i) != 0)
+            res = -1;
+        else
+            fix32_par_pool.threads = i + 1;
+    }
+    pthread_mutex_unlock(&fix32_par_pool.call);
+
+    if (res < 0)
+        fix32_par_shutdown();
+    return res;
+}
+
+void fix32_par_shutdown(void)
+{
+    pthread_mutex_lock(&fix32_par_pool.call);
+    pthread_mutex_lock(&fix32_par_pool.lock);
+    fix32_par_pool.quit = 1;
+    pthread_cond_broadcast(&fix32_par_pool.start);
+    pthread_mutex_unlock(&fix32_par_pool.lock);
+
+    unsigned i;
+    for (i = 1; i < fix32_par_pool.threads; i++)
+        pthread_join(fix32_par_pool.ids[i - 1], NULL);
+    free(fix32_par_pool.ids);
+    fix32_par_pool.ids     = NULL;
+    fix32_par_pool.threads = 1;
+    fix32_par_pool.gen     = 0;
+    fix32_par_pool.quit    = 0;
+    pthread_mutex_unlock(&fix32_par_pool.call);
+}
+
+void fix32_par_for(size_t count, size_t chunk, fix32_par_kernel kernel,
+                   void *ctx)
+{
+    pthread_mutex_lock(&fix32_par_pool.call);
+    fix32_par_pool.count  = count;
+    fix32_par_pool.chunk  = chunk;
+    fix32_par_pool.kernel = kernel;
+    fix32_par_pool.ctx    = ctx;
+
+    if (fix32_par_pool.threads > 1) {
+        pthread_mutex_lock(&fix32_par_pool.lock);
+        fix32_par_pool.pending = fix32_par_pool.threads - 1;
+        fix32_par_pool.gen++;
+        pthread_cond_broadcast(&fix32_par_pool.start);
+        pthread_mutex_unlock(&fix32_par_pool.lock);
+    }
+
+    fix32_par_range(0);
+
+    if (fix32_par_pool.threads > 1) {
+        pthread_mutex_lock(&fix32_par_pool.lock);
+        while (fix32_par_pool.pending > 0)
+            pthread_cond_wait(&fix32_par_pool.done, &fix32_par_pool.lock);
+        pthread_mutex_unlock(&fix32_par_pool.lock);
+    }
+    pthread_mutex_unlock(&fix32_par_pool.call);
+}
+
+
+// arguments of the parallel variants of the batched kernels
+typedef struct fix32_par_args {
+    const void *src;
+    void *dst;
+    size_t elem_size;
+    int scale, res_scale;
+    fix32_rounding rounding;
+} fix32_par_args;
+
+/**
+ * Number of elements per chunk for the given input and output element sizes
+ */
+static size_t fix32_par_chunk(size_t in_size, size_t out_size)
+{
+    return FIX32_PAR_CHUNK_BYTES / (in_size + out_size);
+}
+
+// kernels of the parallel variants, applied to the elements [beg, end)
+
+static void fix32_par_touch_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    memset((char *)args->dst + beg * args->elem_size, 0,
+           (end - beg) * args->elem_size);
+}
+
+void fix32_par_touch(void *buf, size_t count, size_t elem_size)
+{
+    fix32_par_args args;
+    args.dst       = buf;
+    args.elem_size = elem_size;
+    fix32_par_for(count, 0, fix32_par_touch_kernel, &args);
+}
+
+
+static void fix32_par_invsqrt_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    fix32_invsqrt_array((const uint32_t *)args->src + beg,
+                        (int32_t *)args->dst + beg, end - beg, args->scale,
+                        args->res_scale);
+}
+
+void fix32_par_invsqrt_array(const uint32_t *src, int32_t *dst, size_t count,
+                             int scale, int res_scale)
+{
+    fix32_par_args args;
+    args.src       = src;
+    args.dst       = dst;
+    args.scale     = scale;
+    args.res_scale = res_scale;
+    fix32_par_for(count, fix32_par_chunk(4, 4), fix32_par_invsqrt_kernel,
+                  &args);
+}
+
+static void fix32_par_phase_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    fix32_cmplx_phase_array((const fix32_cmplx *)args->src + beg,
+                            (int32_t *)args->dst + beg, end - beg);
+}
+
+void fix32_par_cmplx_phase_array(const fix32_cmplx *a, int32_t *phase,
+                                 size_t count)
+{
+    fix32_par_args args;
+    args.src = a;
+    args.dst = phase;
+    fix32_par_for(count, fix32_par_chunk(sizeof(fix32_cmplx), 4),
+                  fix32_par_phase_kernel, &args);
+}
+
+
+static void fix32_par_from_float_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    fix32_from_float((const float *)args->src + beg,
+                     (int32_t *)args->dst + beg, end - beg, args->scale,
+                     args->rounding);
+}
+
+void fix32_par_from_float(const float *src, int32_t *dst, size_t count,
+                          int scale, fix32_rounding rounding)
+{
+    fix32_par_args args;
+    args.src      = src;
+    args.dst      = dst;
+    args.scale    = scale;
+    args.rounding = rounding;
+    fix32_par_for(count, fix32_par_chunk(sizeof(float), 4),
+                  fix32_par_from_float_kernel, &args);
+}
+
+static void fix32_par_from_double_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    fix32_from_double((const double *)args->src + beg,
+                      (int32_t *)args->dst + beg, end - beg, args->scale,
+                      args->rounding);
+}
+
+void fix32_par_from_double(const double *src, int32_t *dst, size_t count,
+                           int scale, fix32_rounding rounding)
+{
+    fix32_par_args args;
+    args.src      = src;
+    args.dst      = dst;
+    args.scale    = scale;
+    args.rounding = rounding;
+    fix32_par_for(count, fix32_par_chunk(sizeof(double), 4),
+                  fix32_par_from_double_kernel, &args);
+}
+
+static void fix32_par_to_float_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    fix32_to_float((const int32_t *)args->src + beg, (float *)args->dst + beg,
+                   end - beg, args->scale);
+}
+
+void fix32_par_to_float(const int32_t *src, float *dst, size_t count,
+                        int scale)
+{
+    fix32_par_args args;
+    args.src   = src;
+    args.dst   = dst;
+    args.scale = scale;
+    fix32_par_for(count, fix32_par_chunk(4, sizeof(float)),
+                  fix32_par_to_float_kernel, &args);
+}
+
+static void fix32_par_to_double_kernel(size_t beg, size_t end, void *ctx)
+{
+    const fix32_par_args *args = ctx;
+    fix32_to_double((const int32_t *)args->src + beg,
+                    (double *)args->dst + beg, end - beg, args->scale);
+}
+
+void fix32_par_to_double(const int32_t *src, double *dst, size_t count,
+                         int scale)
+{
+    fix32_par_args args;
+    args.src   = src;
+    args.dst   = dst;
+    args.scale = scale;
+    fix32_par_for(count, fix32_par_chunk(4, sizeof(double)),
+                  fix32_par_to_double_kernel, &args);
+}
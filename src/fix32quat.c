@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32vec.h"
+#include "fix32quat.h"
+
+
+/**
+ * Hamilton product of two quaternions with a single rounding per component
+ */
+void fix32_quat_mul(const fix32_quat *a, const fix32_quat *b, fix32_quat *res,
+                    int n)
+{
+    int64_t w = (int64_t)a->w * b->w - (int64_t)a->x * b->x
+              - (int64_t)a->y * b->y - (int64_t)a->z * b->z,
+            x = (int64_t)a->w * b->x + (int64_t)a->x * b->w
+              + (int64_t)a->y * b->z - (int64_t)a->z * b->y,
+            y = (int64_t)a->w * b->y - (int64_t)a->x * b->z
+              + (int64_t)a->y * b->w + (int64_t)a->z * b->x,
+            z = (int64_t)a->w * b->z + (int64_t)a->x * b->y
+              - (int64_t)a->y * b->x + (int64_t)a->z * b->w;
+
+    res->w = FIX32_MATH_MUL_ROUND_FUNC(w, n);
+    res->x = FIX32_MATH_MUL_ROUND_FUNC(x, n);
+    res->y = FIX32_MATH_MUL_ROUND_FUNC(y, n);
+    res->z = FIX32_MATH_MUL_ROUND_FUNC(z, n);
+}
+
+
+void fix32_quat_normalize(const fix32_quat *q, fix32_quat *res)
+{
+    // the 4 components of a quaternion are stored consecutively
+    fix32_vec4_normalize(&q->w, &res->w, 1);
+}
+
+
+/**
+ * Renormalize a nearly normalized quaternion with one Newton iteration
+ */
+void fix32_quat_renormalize(const fix32_quat *q, fix32_quat *res)
+{
+    // squared norm with a scaling factor of 2^60
+    int64_t norm_squ = (int64_t)q->w * q->w + (int64_t)q->x * q->x
+                     + (int64_t)q->y * q->y + (int64_t)q->z * q->z;
+
+    // 1/sqrt(|q|^2) ~= (3 - |q|^2) / 2 with a scaling factor of 2^30
+    int32_t inv = ((3LL << 60) - norm_squ + (1LL << 30)) >> 31;
+
+    res->w = fix32_mul(q->w, inv, 30);
+    res->x = fix32_mul(q->x, inv, 30);
+    res->y = fix32_mul(q->y, inv, 30);
+    res->z = fix32_mul(q->z, inv, 30);
+}
+
+
+/**
+ * Rotate a vector by a unit quaternion
+ */
+void fix32_quat_rotate(const fix32_quat *q, const int32_t v[3], int32_t res[3])
+{
+    // With u = (x, y, z) being the vector part of q:
+    //   v' = v + w * t + u x t , where t = 2 * (u x v)
+
+    // t has the same scaling factor as v (u has a scaling factor of 2^30; the
+    // factor of 2 is accounted for by shifting by 29 bits instead of 30); it
+    // is kept in 64 bits since its components can exceed v by 2 * sqrt(2)
+    int64_t t0 = FIX32_MATH_MUL_ROUND_FUNC((int64_t)q->y * v[2]
+                                         - (int64_t)q->z * v[1], 29),
+            t1 = FIX32_MATH_MUL_ROUND_FUNC((int64_t)q->z * v[0]
+                                         - (int64_t)q->x * v[2], 29),
+            t2 = FIX32_MATH_MUL_ROUND_FUNC((int64_t)q->x * v[1]
+                                         - (int64_t)q->y * v[0], 29);
+
+    // accumulate v (scaled up by 2^30) and both products before rounding
+    int64_t r0 = (int64_t)v[0] * (1 << 30) + (int64_t)q->w * t0
+               + (int64_t)q->y * t2 - (int64_t)q->z * t1,
+            r1 = (int64_t)v[1] * (1 << 30) + (int64_t)q->w * t1
+               + (int64_t)q->z * t0 - (int64_t)q->x * t2,
+            r2 = (int64_t)v[2] * (1 << 30) + (int64_t)q->w * t2
+               + (int64_t)q->x * t1 - (int64_t)q->y * t0;
+
+    res[0] = FIX32_MATH_MUL_ROUND_FUNC(r0, 30);
+    res[1] = FIX32_MATH_MUL_ROUND_FUNC(r1, 30);
+    res[2] = FIX32_MATH_MUL_ROUND_FUNC(r2, 30);
+}
+
+
+/**
+ * Linear interpolation between two quaternions without normalization; 'b' is
+ * negated if required to interpolate along the shorter arc
+ */
+static void fix32_quat_lerp(const fix32_quat *a, const fix32_quat *b,
+                            int32_t t, fix32_quat *res)
+{
+    int64_t dot = (int64_t)a->w * b->w + (int64_t)a->x * b->x
+                + (int64_t)a->y * b->y + (int64_t)a->z * b->z;
+    int64_t sign = (dot < 0) ? -1 : 1;
+
+    // a + (b - a) * t , rounded once per component
+    res->w = FIX32_MATH_MUL_ROUND_FUNC((int64_t)a->w * (1 << 30)
+                                       + (sign * b->w - a->w) * t, 30);
+    res->x = FIX32_MATH_MUL_ROUND_FUNC((int64_t)a->x * (1 << 30)
+                                       + (sign * b->x - a->x) * t, 30);
+    res->y = FIX32_MATH_MUL_ROUND_FUNC((int64_t)a->y * (1 << 30)
+                                       + (sign * b->y - a->y) * t, 30);
+    res->z = FIX32_MATH_MUL_ROUND_FUNC((int64_t)a->z * (1 << 30)
+                                       + (sign * b->z - a->z) * t, 30);
+}
+
+
+void fix32_quat_nlerp(const fix32_quat *a, const fix32_quat *b, int32_t t,
+                      fix32_quat *res)
+{
+    fix32_quat_lerp(a, b, t, res);
+    fix32_quat_normalize(res, res);
+}
+
+
+/**
+ * Spherical linear interpolation between two unit quaternions
+ */
+void fix32_quat_slerp(const fix32_quat *a, const fix32_quat *b, int32_t t,
+                      fix32_quat *res)
+{
+    // cosine of the angle between a and b with a scaling factor of 2^30
+    int32_t cos_theta = FIX32_MATH_MUL_ROUND_FUNC(
+        (int64_t)a->w * b->w + (int64_t)a->x * b->x
+      + (int64_t)a->y * b->y + (int64_t)a->z * b->z, 30);
+
+    // interpolate along the shorter arc
+    int32_t sign = 1;
+    if (cos_theta < 0) {
+        cos_theta = -cos_theta;
+        sign = -1;
+    }
+
+    // fall back to nlerp if the angle is too small for an accurate sine
+    // (i.e., cos(theta) > 0.9995)
+    const int32_t cos_min = 0x3FFDF3B6; // 0.9995 with a scaling factor of 2^30
+    if (cos_theta > cos_min) {
+        fix32_quat_nlerp(a, b, t, res);
+        return;
+    }
+
+    // sin^2(theta) = 1 - cos^2(theta) with a scaling factor of 2^30
+    uint32_t sin_squ = (1 << 30) - fix32_mul(cos_theta, cos_theta, 30);
+
+    // 1/sin(theta) with a scaling factor of 2^inv_scale
+    int inv_scale = 30;
+    int32_t inv_sin = fix32_invsqrt(sin_squ, &inv_scale);
+
+    // sin(theta) = sin^2(theta) / sin(theta), with a scaling factor of 2^30
+    int32_t sin_theta = fix32_mul(sin_squ, inv_sin, inv_scale);
+
+    // theta with a scaling factor of 2^28
+    int32_t theta = fix32_atan2(sin_theta, cos_theta, 30);
+
+    // weights sin((1 - t) * theta) / sin(theta) and
+    // sin(t * theta) / sin(theta) with a scaling factor of 2^30
+    int32_t sin_a, sin_b, unused;
+    fix32_sincos(fix32_mul(theta, (1 << 30) - t, 30), &sin_a, &unused);
+    fix32_sincos(fix32_mul(theta, t, 30), &sin_b, &unused);
+    int32_t wa = fix32_mul(sin_a, inv_sin, inv_scale),
+            wb = fix32_mul(sin_b, inv_sin, inv_scale) * sign;
+
+    res->w = FIX32_MATH_MUL_ROUND_FUNC((int64_t)wa * a->w
+                                       + (int64_t)wb * b->w, 30);
+    res->x = FIX32_MATH_MUL_ROUND_FUNC((int64_t)wa * a->x
+                                       + (int64_t)wb * b->x, 30);
+    res->y = FIX32_MATH_MUL_ROUND_FUNC((int64_t)wa * a->y
+                                       + (int64_t)wb * b->y, 30);
+    res->z = FIX32_MATH_MUL_ROUND_FUNC((int64_t)wa * a->z
+                                       + (int64_t)wb * b->z, 30);
+
+    // compensate for the approximation error of the angle
+    fix32_quat_renormalize(res, res);
+}
+
+
+void fix32_quat_mul_array(const fix32_quat *a, const fix32_quat *b,
+                          fix32_quat *res, size_t count, int n)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        // copy the operands since res may alias a or b
+        fix32_quat qa = a[i], qb = b[i];
+        fix32_quat_mul(&qa, &qb, &res[i], n);
+    }
+}
+
+void fix32_quat_renormalize_array(const fix32_quat *q, fix32_quat *res,
+                                  size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        fix32_quat_renormalize(&q[i], &res[i]);
+}
+
+
+void fix32_quat_rotate_array(const fix32_quat *q, const int32_t *src,
+                             int32_t *dst, size_t count)
+{
+    int64_t wx = (int64_t)q->w * q->x, wy = (int64_t)q->w * q->y,
+            wz = (int64_t)q->w * q->z, xx = (int64_t)q->x * q->x,
+            xy = (int64_t)q->x * q->y, xz = (int64_t)q->x * q->z,
+            yy = (int64_t)q->y * q->y, yz = (int64_t)q->y * q->z,
+            zz = (int64_t)q->z * q->z;
+
+    // rotation matrix with a scaling factor of 2^30; the products have a
+    // scaling factor of 2^60 and are doubled by shifting by 29 bits only
+    const int64_t one = 1LL << 59; // 1/2 with a scaling factor of 2^60
+    int32_t m[9] = {
+        FIX32_MATH_MUL_ROUND_FUNC(one - yy - zz, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(xy - wz, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(xz + wy, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(xy + wz, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(one - xx - zz, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(yz - wx, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(xz - wy, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(yz + wx, 29),
+        FIX32_MATH_MUL_ROUND_FUNC(one - xx - yy, 29)
+    };
+
+    size_t i;
+    for (i = 0; i < count; i++) {
+        int64_t v0 = src[3 * i], v1 = src[3 * i + 1], v2 = src[3 * i + 2];
+        dst[3 * i]     = FIX32_MATH_MUL_ROUND_FUNC(m[0] * v0 + m[1] * v1
+                                                 + m[2] * v2, 30);
+        dst[3 * i + 1] = FIX32_MATH_MUL_ROUND_FUNC(m[3] * v0 + m[4] * v1
+                                                 + m[5] * v2, 30);
+        dst[3 * i + 2] = FIX32_MATH_MUL_ROUND_FUNC(m[6] * v0 + m[7] * v1
+                                                 + m[8] * v2, 30);
+    }
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32str.h"
+
+
+/**
+ * Write the decimal digits of 'val' to 'str' and return their number
+ */
+static size_t fix32_str_uint(uint32_t val, char *str)
+{
+    char tmp[10];
+    size_t len = 0;
+    do {
+        tmp[len++] = (char)('0' + val % 10);
+        val /= 10;
+    } while (val);
+
+    size_t i;
+    for (i = 0; i < len; i++)
+        str[i] = tmp[len - 1 - i];
+    return len;
+}
+
+size_t fix32_to_str(int32_t val, char *str, int scale, unsigned digits)
+{
+    char *pos = str;
+    uint32_t mag = (uint32_t)val;
+    if (val < 0) {
+        mag = -mag;
+        *pos++ = '-';
+    }
+
+    // integer part and fraction (the latter at 2^scale)
+    uint64_t mask = ((uint64_t)1 << scale) - 1;
+    uint32_t ipart = (uint32_t)((uint64_t)mag >> scale);
+    uint64_t frac  = mag & mask;
+
+    // the fraction has exactly 'scale' decimal digits, hence rounding is only
+    // needed for fewer digits (which are buffered for the carry)
+    char     fdig[32];
+    unsigned fcnt = (digits < (unsigned)scale) ? digits : (unsigned)scale;
+    unsigned i;
+    for (i = 0; i < fcnt; i++) {
+        frac *= 10;
+        fdig[i] = (char)('0' + (frac >> scale));
+        frac &= mask;
+    }
+    if (fcnt < (unsigned)scale) {
+        // round the remainder to nearest, ties to even
+        uint64_t half = (uint64_t)1 << (scale - 1);
+        int      odd  = (fcnt == 0) ? (int)(ipart & 1) : (fdig[fcnt - 1] & 1);
+        if (frac > half || (frac == half && odd)) {
+            for (i = fcnt; i > 0 && fdig[i - 1] == '9'; i--)
+                fdig[i - 1] = '0';
+            if (i > 0)
+                fdig[i - 1]++;
+            else
+                ipart++;
+        }
+    }
+
+    pos += fix32_str_uint(ipart, pos);
+    if (digits > 0) {
+        *pos++ = '.';
+        for (i = 0; i < fcnt; i++)
+            *pos++ = fdig[i];
+        for (; i < digits; i++)
+            *pos++ = '0';
+    }
+    *pos = '\0';
+    return (size_t)(pos - str);
+}
+
+size_t fix32_to_str_array(const int32_t *src, char *dst, size_t count,
+                          int scale, unsigned digits, char sep)
+{
+    char *pos = dst;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        if (i > 0)
+            *pos++ = sep;
+        pos += fix32_to_str(src[i], pos, scale, digits);
+    }
+    *pos = '\0';
+    return (size_t)(pos - dst);
+}
+
+
+/**
+ * Check whether a character is white space
+ */
+static int fix32_str_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * Check whether a character is a decimal digit
+ */
+static int fix32_str_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int32_t fix32_from_str(const char *str, const char **end, int scale,
+                       fix32_rounding rounding)
+{
+    const char *pos = str;
+    while (fix32_str_space(*pos))
+        pos++;
+
+    int neg = (*pos == '-');
+    if (*pos == '-' || *pos == '+')
+        pos++;
+
+    // integer part, limited to 2^31 (larger values saturate anyway)
+    uint64_t ipart = 0;
+    size_t   ndig  = 0;
+    for (; fix32_str_digit(*pos); pos++, ndig++) {
+        ipart = ipart * 10 + (uint64_t)(*pos - '0');
+        ipart = (ipart > 0x80000000u) ? 0x80000000u : ipart;
+    }
+    const char *frac_beg = pos, *frac_end = pos;
+    if (*pos == '.') {
+        frac_beg = ++pos;
+        for (; fix32_str_digit(*pos); pos++, ndig++)
+            ;
+        frac_end = pos;
+    }
+    if (ndig == 0) {
+        if (end)
+            *end = str;
+        return 0;
+    }
+    if (end)
+        *end = pos;
+
+    // the fraction times 2^64 rounded towards zero and a sticky flag for the
+    // remainder, evaluated from the last digit (Horner scheme); the floor of
+    // (digit * 2^64 + frac) / 10 is exact as the remainder is less than 1
+    uint64_t frac   = 0;
+    int      sticky = 0;
+    const char *dig;
+    for (dig = frac_end; dig > frac_beg; dig--) {
+        uint64_t rem = (uint64_t)(dig[-1] - '0');
+        uint64_t hi  = (rem << 32) | (frac >> 32);
+        rem = hi % 10;
+        uint64_t lo  = (rem << 32) | (frac & 0xFFFFFFFFu);
+        rem = lo % 10;
+        frac   = ((hi / 10) << 32) | (lo / 10);
+        sticky = sticky || (rem != 0);
+    }
+
+    // round the magnitude, with ties rounded up or down depending on the sign
+    uint64_t res  = ipart << scale;
+    uint64_t rest = frac << scale;
+    res += (scale > 0) ? (frac >> (64 - scale)) : 0;
+    int tie_up = neg ? (rounding == FIX32_RHD || rounding == FIX32_RHAZ)
+                     : (rounding == FIX32_RHU || rounding == FIX32_RHAZ);
+    uint64_t half = (uint64_t)1 << 63;
+    res += (rest > half) || (rest == half && (sticky || tie_up));
+
+    if (neg)
+        return (res >= 0x80000000u) ? INT32_MIN : -(int32_t)res;
+    return (res > INT32_MAX) ? INT32_MAX : (int32_t)res;
+}
+
+size_t fix32_from_str_array(const char *src, int32_t *dst, size_t count,
+                            int scale, fix32_rounding rounding,
+                            const char **end)
+{
+    const char *pos = src, *last = src;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        const char *next;
+        int32_t val = fix32_from_str(pos, &next, scale, rounding);
+        if (next == pos)
+            break;
+        dst[i] = val;
+        pos = last = next;
+
+        // skip the separator
+        while (fix32_str_space(*next))
+            next++;
+        if (*next == ',')
+            pos = next + 1;
+    }
+    if (end)
+        *end = last;
+    return i;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix32vec.h"
+
+
+/**
+ * Smallest even number of bits by which 'val' has to be shifted right to
+ * become 0, i.e. its bit length rounded up to an even number; without
+ * branches, since the lengths of consecutive vectors are unrelated
+ */
+static inline int fix32_vec_even_len(uint32_t val)
+{
+    int len, shift;
+    len   = (val > 0xFFFF) << 4;
+    val >>= len;
+    shift = (val > 0xFF) << 3;
+    len  += shift;
+    val >>= shift;
+    shift = (val > 0xF) << 2;
+    len  += shift;
+    val >>= shift;
+    shift = (val > 0x3) << 1;
+    len  += shift;
+    val >>= shift;
+    return len + ((val != 0) << 1);
+}
+
+
+/**
+ * Normalize 'count' vectors with 'dim' components each.  Component 'd' of
+ * vector 'i' is read from src[d][i * stride] and written to
+ * dst[d][i * stride], which covers both the AoS layout (stride = dim) and the
+ * SoA layout (stride = 1).  Called with constant 'dim' and 'stride' only, such
+ * that the compiler can unroll the component loops.
+ */
+static void fix32_vec_normalize(const int32_t *const *src, int32_t *const *dst,
+                                int dim, size_t stride, size_t count)
+{
+    size_t i;
+    int d;
+    for (i = 0; i < count; i++) {
+        size_t idx = i * stride;
+
+        // squared length of the vector; at most 4 * 2^62, which fits into an
+        // unsigned 64-bit integer unless all 4 components are -2^31
+        uint64_t dot = 0;
+        for (d = 0; d < dim; d++) {
+            int64_t v = src[d][idx];
+            dot += (uint64_t)(v * v);
+        }
+
+        if (dot == 0) {
+            for (d = 0; d < dim; d++)
+                dst[d][idx] = 0;
+            continue;
+        }
+
+        // reduce the squared length to 32 bits by shifting it by an even
+        // number of bits (the components are treated as integers, i.e. with
+        // a scaling factor of 2^0, thus the shift yields a negative scale)
+        int shift = fix32_vec_even_len(dot >> 32);
+        int scale = -shift;
+        uint32_t inv = fix32_invsqrt(dot >> shift, &scale);
+
+        // component * inv has a scaling factor of 2^scale, whereas the unit
+        // vector shall have a scaling factor of 2^30; since 'scale' may be
+        // as low as 30, the product is doubled to always shift by at least 1
+        int n = scale - 30 + 1;
+        for (d = 0; d < dim; d++) {
+            int64_t prod = (int64_t)src[d][idx] * inv * 2;
+            dst[d][idx] = FIX32_MATH_MUL_ROUND_FUNC(prod, n);
+        }
+    }
+}
+
+
+void fix32_vec2_normalize(const int32_t *src, int32_t *dst, size_t count)
+{
+    const int32_t *s[2] = { src, src + 1 };
+    int32_t *r[2] = { dst, dst + 1 };
+    fix32_vec_normalize(s, r, 2, 2, count);
+}
+
+void fix32_vec3_normalize(const int32_t *src, int32_t *dst, size_t count)
+{
+    const int32_t *s[3] = { src, src + 1, src + 2 };
+    int32_t *r[3] = { dst, dst + 1, dst + 2 };
+    fix32_vec_normalize(s, r, 3, 3, count);
+}
+
+void fix32_vec4_normalize(const int32_t *src, int32_t *dst, size_t count)
+{
+    const int32_t *s[4] = { src, src + 1, src + 2, src + 3 };
+    int32_t *r[4] = { dst, dst + 1, dst + 2, dst + 3 };
+    fix32_vec_normalize(s, r, 4, 4, count);
+}
+
+
+void fix32_vec2_normalize_soa(const int32_t *x, const int32_t *y,
+                              int32_t *ux, int32_t *uy, size_t count)
+{
+    const int32_t *s[2] = { x, y };
+    int32_t *r[2] = { ux, uy };
+    fix32_vec_normalize(s, r, 2, 1, count);
+}
+
+void fix32_vec3_normalize_soa(const int32_t *x, const int32_t *y,
+                              const int32_t *z,
+                              int32_t *ux, int32_t *uy, int32_t *uz,
+                              size_t count)
+{
+    const int32_t *s[3] = { x, y, z };
+    int32_t *r[3] = { ux, uy, uz };
+    fix32_vec_normalize(s, r, 3, 1, count);
+}
+
+void fix32_vec4_normalize_soa(const int32_t *x, const int32_t *y,
+                              const int32_t *z, const int32_t *w,
+                              int32_t *ux, int32_t *uy, int32_t *uz,
+                              int32_t *uw, size_t count)
+{
+    const int32_t *s[4] = { x, y, z, w };
+    int32_t *r[4] = { ux, uy, uz, uw };
+    fix32_vec_normalize(s, r, 4, 1, count);
+}
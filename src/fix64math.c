@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include "fix32math.h"
+#include "fix64math.h"
+
+
+/**
+ * Index of the highest set bit of a non-zero 64-bit value
+ */
+static int fix64_msb(uint64_t val)
+{
+    int msb = 0;
+    if (val & 0xFFFFFFFF00000000uLL) {
+        val >>= 32;
+        msb += 32;
+    }
+    if (val & 0xFFFF0000u) {
+        val >>= 16;
+        msb += 16;
+    }
+    if (val & 0xFF00u) {
+        val >>= 8;
+        msb += 8;
+    }
+    if (val & 0xF0u) {
+        val >>= 4;
+        msb += 4;
+    }
+    if (val & 0xCu) {
+        val >>= 2;
+        msb += 2;
+    }
+    if (val & 0x2u)
+        msb += 1;
+    return msb;
+}
+
+
+/**
+ * Split val with a scaling factor of 2^scale into a * 2^(2n) with 1 <= a < 4 ;
+ * returns a with a scaling factor of 2^61 and stores n.  Undefined for 0.
+ */
+static int64_t fix64_split_even(uint64_t val, int scale, int *n)
+{
+    // exponent e of the highest power of 2 below val with the same parity as
+    // scale, such that 1 <= val / 2^e < 4
+    int msb = fix64_msb(val);
+    int e = msb - ((msb - scale) & 1);
+
+    *n = (e - scale) >> 1;
+    return (e <= 61) ? (int64_t)(val << (61 - e)) : (int64_t)(val >> (e - 61));
+}
+
+
+/**
+ * Inverse square root of a with a scaling factor of 2^61 (1 <= a < 4), with
+ * a scaling factor of 2^62
+ */
+static int64_t fix64_invsqrt_norm(int64_t a)
+{
+    // initial approximation from the upper 32 bits of a, which have a scaling
+    // factor of 2^30
+    int seed_scale = 30;
+    uint32_t seed = fix32_invsqrt((uint32_t)(a >> 31), &seed_scale);
+    int64_t res = (int64_t)seed << (62 - seed_scale);
+
+    // Newton's method: res = res * (1.5 - a * res^2 / 2) ; 0.5 < res <= 1 ;
+    // the seed is accurate to about 2^-13, which requires three iterations
+    const int64_t _1p5 = 3LL << 60; // 1.5 with a scaling factor of 2^61
+    int i;
+    for (i = 0; i < 3; i++) {
+        int64_t res_squ = fix64_mul(res, res, 62);          // scale 2^62
+        int64_t half_a_res_squ = fix64_mul(a, res_squ, 63); // scale 2^61
+        res = fix64_mul(res, _1p5 - half_a_res_squ, 61);    // scale 2^62
+    }
+    return res;
+}
+
+
+/**
+ * Approximate the inverse square root of a 64-bit fixed point value
+ */
+uint64_t fix64_invsqrt(uint64_t val, int *scale)
+{
+    // val = a * 2^(2n) , hence 1/sqrt(val) = 1/sqrt(a) * 2^(-n)
+    int n;
+    int64_t a = fix64_split_even(val, *scale, &n);
+    *scale = 62 + n;
+    return fix64_invsqrt_norm(a);
+}
+
+
+/**
+ * Approximate the square root of a 64-bit fixed point value
+ */
+uint64_t fix64_sqrt(uint64_t val, int *scale)
+{
+    if (val == 0)
+        return 0;
+
+    // val = a * 2^(2n) , hence sqrt(val) = a / sqrt(a) * 2^n , where
+    // 1 <= sqrt(a) < 2 is stored with a scaling factor of 2^61
+    int n;
+    int64_t a = fix64_split_even(val, *scale, &n);
+    *scale = 61 - n;
+    return fix64_mul(a, fix64_invsqrt_norm(a), 62);
+}
+
+
+/**
+ * Approximate atan2 with CORDIC iterations
+ */
+int64_t fix64_atan2(int64_t y, int64_t x, int scale)
+{
+    // atan(2^-i) with a scaling factor of 2^60
+    static const int64_t atan_tab[] = {
+    0x0C90FDAA22168C23LL, // atan(2^-0)
+    0x076B19C1586ED3DALL, // atan(2^-1)
+    0x03EB6EBF25901BACLL, // atan(2^-2)
+    0x01FD5BA9AAC2F6DCLL, // atan(2^-3)
+    0x00FFAADDB967EF4ELL, // atan(2^-4)
+    0x007FF556EEA5D893LL, // atan(2^-5)
+    0x003FFEAAB776E535LL, // atan(2^-6)
+    0x001FFFD555BBBA97LL, // atan(2^-7)
+    0x000FFFFAAAADDDDCLL, // atan(2^-8)
+    0x0007FFFF55556EEFLL, // atan(2^-9)
+    0x0003FFFFEAAAAB77LL, // atan(2^-10)
+    0x0001FFFFFD55555CLL, // atan(2^-11)
+    0x0000FFFFFFAAAAABLL, // atan(2^-12)
+    0x00007FFFFFF55555LL, // atan(2^-13)
+    0x00003FFFFFFEAAABLL, // atan(2^-14)
+    0x00001FFFFFFFD555LL, // atan(2^-15)
+    0x00000FFFFFFFFAABLL, // atan(2^-16)
+    0x000007FFFFFFFF55LL, // atan(2^-17)
+    0x000003FFFFFFFFEBLL, // atan(2^-18)
+    0x000001FFFFFFFFFDLL, // atan(2^-19)
+    0x0000010000000000LL, // atan(2^-20)
+    0x0000008000000000LL, // atan(2^-21)
+    0x0000004000000000LL, // atan(2^-22)
+    0x0000002000000000LL, // atan(2^-23)
+    0x0000001000000000LL, // atan(2^-24)
+    0x0000000800000000LL, // atan(2^-25)
+    0x0000000400000000LL, // atan(2^-26)
+    0x0000000200000000LL, // atan(2^-27)
+    0x0000000100000000LL, // atan(2^-28)
+    0x0000000080000000LL, // atan(2^-29)
+    0x0000000040000000LL, // atan(2^-30)
+    0x0000000020000000LL, // atan(2^-31)
+    0x0000000010000000LL, // atan(2^-32)
+    0x0000000008000000LL, // atan(2^-33)
+    0x0000000004000000LL, // atan(2^-34)
+    0x0000000002000000LL, // atan(2^-35)
+    0x0000000001000000LL, // atan(2^-36)
+    0x0000000000800000LL, // atan(2^-37)
+    0x0000000000400000LL, // atan(2^-38)
+    0x0000000000200000LL, // atan(2^-39)
+    0x0000000000100000LL, // atan(2^-40)
+    0x0000000000080000LL, // atan(2^-41)
+    0x0000000000040000LL, // atan(2^-42)
+    0x0000000000020000LL, // atan(2^-43)
+    0x0000000000010000LL, // atan(2^-44)
+    0x0000000000008000LL, // atan(2^-45)
+    0x0000000000004000LL, // atan(2^-46)
+    0x0000000000002000LL, // atan(2^-47)
+    0x0000000000001000LL, // atan(2^-48)
+    0x0000000000000800LL, // atan(2^-49)
+    0x0000000000000400LL, // atan(2^-50)
+    0x0000000000000200LL, // atan(2^-51)
+    0x0000000000000100LL, // atan(2^-52)
+    0x0000000000000080LL, // atan(2^-53)
+    0x0000000000000040LL, // atan(2^-54)
+    0x0000000000000020LL, // atan(2^-55)
+    0x0000000000000010LL, // atan(2^-56)
+    0x0000000000000008LL, // atan(2^-57)
+    0x0000000000000004LL, // atan(2^-58)
+    0x0000000000000002LL, // atan(2^-59)
+    0x0000000000000001LL, // atan(2^-60)
+    };
+
+    const int64_t pi_half = 0x1921FB54442D1847LL; // pi/2 with scale 2^60
+
+    // the result only depends on the ratio of y and x (see 'fix32_atan2()')
+    (void)scale;
+
+    uint64_t abs_x = (x >= 0) ? (uint64_t)x : -(uint64_t)x,
+             abs_y = (y >= 0) ? (uint64_t)y : -(uint64_t)y;
+
+    if ((abs_x | abs_y) == 0)
+        return 0;
+
+    // normalize x and y such that the highest set bit of the larger magnitude
+    // is at index 60; the CORDIC gain of about 1.65 then leaves the magnitude
+    // of the vector below 2^63
+    int msb = fix64_msb(abs_x | abs_y);
+    if (msb > 60) {
+        x >>= msb - 60;
+        y >>= msb - 60;
+    } else {
+        x = (int64_t)((uint64_t)x << (60 - msb));
+        y = (int64_t)((uint64_t)y << (60 - msb));
+    }
+
+    // rotate the vector by -pi/2 or pi/2 into the right half-plane
+    int64_t angle = 0, tmp;
+    if (x < 0) {
+        tmp = x;
+        if (y >= 0) {
+            x = y;
+            y = -tmp;
+            angle = pi_half;
+        } else {
+            x = -y;
+            y = tmp;
+            angle = -pi_half;
+        }
+    }
+
+    // rotate the vector towards the x-axis by +/- atan(2^-i) in each step and
+    // accumulate the angle; the direction of rotation is applied branch-free
+    // with the mask 'dir', which is 0 for y >= 0 and -1 otherwise (i.e.,
+    // (v ^ dir) - dir is v for y >= 0 and -v otherwise)
+    int i;
+    for (i = 0; i < (int)(sizeof(atan_tab) / sizeof(atan_tab[0])); i++) {
+        int64_t dir = y >> 63;
+        tmp = x;
+        x     += ((y >> i) ^ dir) - dir;
+        y     -= ((tmp >> i) ^ dir) - dir;
+        angle += (atan_tab[i] ^ dir) - dir;
+    }
+    return angle;
+}
@@ -0,0 +1,977 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Benchmarks for libfix32math
+ *
+ * Times the kernels of the library on the build host ('make bench') and
+ * reports the time per element, next to a plain loop of scalar library calls
+ * computing the same result where the kernel replaces such a loop.  The
+ * absolute numbers depend on the host; the ratios indicate the gain of a
+ * kernel on targets with similar costs of multiplications and branches.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fix32math.h"
+#include "fix32biquad.h"
+#include "fix32cmplx.h"
+#include "fix32fft.h"
+#include "fix32fir.h"
+#include "fix32nco.h"
+#include "fix32par.h"
+#include "fix32quat.h"
+#include "fix32vec.h"
+
+
+// number of elements (vectors, samples, ...) processed per call
+#define BENCH_N 1024
+
+// number of timed rounds of a benchmark, of which the fastest is reported
+#define BENCH_ROUNDS 5
+
+// minimum run time of a round in nanoseconds
+#define BENCH_MIN_NS 2e7
+
+// results are written here, such that the compiler cannot drop the work
+static volatile int32_t bench_sink;
+
+static int32_t src[4 * BENCH_N], dst[4 * BENCH_N];
+
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Call 'fn' repeatedly, doubling the number of calls until they take at least
+ * BENCH_MIN_NS, and return the time per call in nanoseconds of the fastest of
+ * BENCH_ROUNDS rounds (which is the least disturbed by other processes)
+ */
+static double bench(void (*fn)(void))
+{
+    size_t reps = 1, i;
+    double best = 0.;
+    int round = 0;
+    while (round < BENCH_ROUNDS) {
+        double start = bench_now();
+        for (i = 0; i < reps; i++)
+            fn();
+        double elapsed = bench_now() - start;
+        if (elapsed < BENCH_MIN_NS) {
+            reps *= 2;
+            continue;
+        }
+        if (round == 0 || elapsed / reps < best)
+            best = elapsed / reps;
+        round++;
+    }
+    return best;
+}
+
+/**
+ * Time 'fn' processing 'elems' elements per call and print the time per
+ * element and the throughput in million elements per second; if 'ref_ns' is
+ * positive, also print the speedup relative to a reference that took 'ref_ns'
+ * nanoseconds per element.  Returns the time per element.
+ */
+static double report(const char *name, void (*fn)(void), size_t elems,
+                     double ref_ns)
+{
+    double ns = bench(fn) / elems;
+    printf("  %-36s %9.2f ns %9.2f M/s", name, ns, 1e3 / ns);
+    if (ref_ns > 0.)
+        printf("  %6.2fx", ref_ns / ns);
+    printf("\n");
+    return ns;
+}
+
+/**
+ * Fill 'buf' with 'count' pseudo-random values in [-2^bits, 2^bits)
+ */
+static void bench_fill(int32_t *buf, size_t count, int bits)
+{
+    static uint32_t state = 1;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        state = state * 1664525u + 1013904223u;
+        buf[i] = (int32_t)state >> (31 - bits);
+    }
+}
+
+
+/**
+ * Vector normalization: batched kernels vs. a loop normalizing one vector at
+ * a time with the scalar functions, as written by hand before the kernels
+ * existed (components with a scaling factor of 2^30 and a magnitude below
+ * 0.5, since the squared length is kept in 32 bits; the kernels accept any
+ * magnitude)
+ */
+static void bench_vec_scalar(int dim)
+{
+    size_t i;
+    int d;
+    for (i = 0; i < BENCH_N; i++) {
+        const int32_t *v = &src[dim * i];
+        int32_t sq = 0;
+        for (d = 0; d < dim; d++)
+            sq += fix32_mul(v[d], v[d], 30);
+        int scale = 30;
+        int32_t inv = sq ? (int32_t)fix32_invsqrt(sq, &scale) : 0;
+        for (d = 0; d < dim; d++)
+            dst[dim * i + d] = fix32_mul(v[d], inv, scale);
+    }
+    bench_sink = dst[0];
+}
+
+static void bench_vec2_scalar(void) { bench_vec_scalar(2); }
+static void bench_vec3_scalar(void) { bench_vec_scalar(3); }
+static void bench_vec4_scalar(void) { bench_vec_scalar(4); }
+
+static void bench_vec2_aos(void)
+{
+    fix32_vec2_normalize(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_vec3_aos(void)
+{
+    fix32_vec3_normalize(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_vec4_aos(void)
+{
+    fix32_vec4_normalize(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_vec2_soa(void)
+{
+    fix32_vec2_normalize_soa(src, src + BENCH_N, dst, dst + BENCH_N,
+                             BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_vec3_soa(void)
+{
+    fix32_vec3_normalize_soa(src, src + BENCH_N, src + 2 * BENCH_N,
+                             dst, dst + BENCH_N, dst + 2 * BENCH_N, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_vec4_soa(void)
+{
+    fix32_vec4_normalize_soa(src, src + BENCH_N, src + 2 * BENCH_N,
+                             src + 3 * BENCH_N, dst, dst + BENCH_N,
+                             dst + 2 * BENCH_N, dst + 3 * BENCH_N, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_vec(void)
+{
+    double ref;
+    printf("vector normalization (fix32vec.h):\n");
+    bench_fill(src, 4 * BENCH_N, 29);
+    ref = report("vec2 scalar loop", bench_vec2_scalar, BENCH_N, 0.);
+    report("fix32_vec2_normalize", bench_vec2_aos, BENCH_N, ref);
+    report("fix32_vec2_normalize_soa", bench_vec2_soa, BENCH_N, ref);
+    ref = report("vec3 scalar loop", bench_vec3_scalar, BENCH_N, 0.);
+    report("fix32_vec3_normalize", bench_vec3_aos, BENCH_N, ref);
+    report("fix32_vec3_normalize_soa", bench_vec3_soa, BENCH_N, ref);
+    ref = report("vec4 scalar loop", bench_vec4_scalar, BENCH_N, 0.);
+    report("fix32_vec4_normalize", bench_vec4_aos, BENCH_N, ref);
+    report("fix32_vec4_normalize_soa", bench_vec4_soa, BENCH_N, ref);
+}
+
+
+/**
+ * Quaternions: Hamilton product vs. 16 separately rounded fix32_mul() calls,
+ * renormalization of nearly unit quaternions vs. full normalization, rotation
+ * of many vectors by one quaternion vs. a loop of single rotations, and an
+ * IMU attitude update (product with a small rotation and renormalization)
+ */
+static fix32_quat quat_a[BENCH_N], quat_b[BENCH_N], quat_res[BENCH_N];
+
+static void bench_quat_mul_scalar(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++) {
+        const fix32_quat *a = &quat_a[i], *b = &quat_b[i];
+        fix32_quat *r = &quat_res[i];
+        r->w = fix32_mul(a->w, b->w, 30) - fix32_mul(a->x, b->x, 30)
+             - fix32_mul(a->y, b->y, 30) - fix32_mul(a->z, b->z, 30);
+        r->x = fix32_mul(a->w, b->x, 30) + fix32_mul(a->x, b->w, 30)
+             + fix32_mul(a->y, b->z, 30) - fix32_mul(a->z, b->y, 30);
+        r->y = fix32_mul(a->w, b->y, 30) - fix32_mul(a->x, b->z, 30)
+             + fix32_mul(a->y, b->w, 30) + fix32_mul(a->z, b->x, 30);
+        r->z = fix32_mul(a->w, b->z, 30) + fix32_mul(a->x, b->y, 30)
+             - fix32_mul(a->y, b->x, 30) + fix32_mul(a->z, b->w, 30);
+    }
+    bench_sink = quat_res[0].w;
+}
+
+static void bench_quat_mul(void)
+{
+    fix32_quat_mul_array(quat_a, quat_b, quat_res, BENCH_N, 30);
+    bench_sink = quat_res[0].w;
+}
+
+static void bench_quat_normalize(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        fix32_quat_normalize(&quat_a[i], &quat_res[i]);
+    bench_sink = quat_res[0].w;
+}
+
+static void bench_quat_renormalize(void)
+{
+    fix32_quat_renormalize_array(quat_a, quat_res, BENCH_N);
+    bench_sink = quat_res[0].w;
+}
+
+static void bench_quat_rotate_scalar(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        fix32_quat_rotate(&quat_a[0], &src[3 * i], &dst[3 * i]);
+    bench_sink = dst[0];
+}
+
+static void bench_quat_rotate(void)
+{
+    fix32_quat_rotate_array(&quat_a[0], src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_quat_update(void)
+{
+    fix32_quat_mul_array(quat_a, quat_b, quat_res, BENCH_N, 30);
+    fix32_quat_renormalize_array(quat_res, quat_res, BENCH_N);
+    bench_sink = quat_res[0].w;
+}
+
+static void bench_quat(void)
+{
+    double ref;
+    size_t i;
+    printf("quaternions (fix32quat.h):\n");
+
+    // unit quaternions 'a' and small rotations 'b' (about 0.1 rad)
+    bench_fill((int32_t *)quat_a, 4 * BENCH_N, 29);
+    bench_fill((int32_t *)quat_b, 4 * BENCH_N, 25);
+    for (i = 0; i < BENCH_N; i++) {
+        fix32_quat_normalize(&quat_a[i], &quat_a[i]);
+        quat_b[i].w = 1 << 30;
+        fix32_quat_normalize(&quat_b[i], &quat_b[i]);
+    }
+    bench_fill(src, 3 * BENCH_N, 29);
+
+    ref = report("product, fix32_mul loop", bench_quat_mul_scalar, BENCH_N,
+                 0.);
+    report("fix32_quat_mul_array", bench_quat_mul, BENCH_N, ref);
+    ref = report("fix32_quat_normalize loop", bench_quat_normalize, BENCH_N,
+                 0.);
+    report("fix32_quat_renormalize_array", bench_quat_renormalize, BENCH_N,
+           ref);
+    ref = report("fix32_quat_rotate loop", bench_quat_rotate_scalar, BENCH_N,
+                 0.);
+    report("fix32_quat_rotate_array", bench_quat_rotate, BENCH_N, ref);
+    report("IMU update (mul + renormalize)", bench_quat_update, BENCH_N, 0.);
+}
+
+
+/**
+ * Dot products: one rounding at the end vs. a chain of rounded fix32_mul()
+ * calls (values with a scaling factor of 2^30 and a magnitude below 1)
+ */
+static void bench_dot_scalar(void)
+{
+    int32_t acc = 0;
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        acc += fix32_mul(src[i], dst[i], 30);
+    bench_sink = acc;
+}
+
+static void bench_dot_plain(void)
+{
+    bench_sink = fix32_dot(src, dst, BENCH_N, 30);
+}
+
+static void bench_dot_strided(void)
+{
+    bench_sink = fix32_dot_strided(src, 4, dst, 4, BENCH_N, 30);
+}
+
+static void bench_dot_wide(void)
+{
+    bench_sink = fix32_dot_wide(src, dst, BENCH_N, 30);
+}
+
+static void bench_dot(void)
+{
+    double ref;
+    printf("dot products (fix32base.h):\n");
+    bench_fill(src, 4 * BENCH_N, 29);
+    bench_fill(dst, 4 * BENCH_N, 29);
+    ref = report("fix32_mul chain", bench_dot_scalar, BENCH_N, 0.);
+    report("fix32_dot", bench_dot_plain, BENCH_N, ref);
+    report("fix32_dot_strided (stride 4)", bench_dot_strided, BENCH_N, ref);
+    report("fix32_dot_wide", bench_dot_wide, BENCH_N, ref);
+}
+
+
+/**
+ * FIR filters of several lengths: block processing vs. a loop that shifts
+ * the delay line and accumulates rounded fix32_mul() products; the
+ * throughput is given in input samples
+ */
+#define BENCH_FIR_MAX_TAPS 128
+
+static int32_t fir_coeffs[BENCH_FIR_MAX_TAPS];
+static int32_t fir_delay[2 * BENCH_FIR_MAX_TAPS];
+static fix32_fir fir;
+
+static void bench_fir_scalar(void)
+{
+    size_t i, k;
+    for (i = 0; i < BENCH_N; i++) {
+        memmove(&fir_delay[1], &fir_delay[0],
+                (fir.taps - 1) * sizeof(int32_t));
+        fir_delay[0] = src[i];
+        int32_t acc = 0;
+        for (k = 0; k < fir.taps; k++)
+            acc += fix32_mul(fir_coeffs[k], fir_delay[k], 30);
+        dst[i] = acc;
+    }
+    bench_sink = dst[0];
+}
+
+static void bench_fir_process(void)
+{
+    fix32_fir_process(&fir, src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_fir_decimate(void)
+{
+    bench_sink = (int32_t)fix32_fir_decimate(&fir, src, dst, BENCH_N, 4);
+}
+
+static void bench_fir_interpolate(void)
+{
+    fix32_fir_interpolate(&fir, src, dst, BENCH_N, 4);
+    bench_sink = dst[0];
+}
+
+static void bench_fir(void)
+{
+    static const size_t taps[] = { 8, 32, 128 };
+    char name[64];
+    size_t t;
+    printf("FIR filters (fix32fir.h):\n");
+    bench_fill(src, BENCH_N, 29);
+    bench_fill(fir_coeffs, BENCH_FIR_MAX_TAPS, 24);
+    for (t = 0; t < sizeof(taps) / sizeof(taps[0]); t++) {
+        double ref;
+        fix32_fir_init(&fir, fir_coeffs, taps[t], fir_delay, 30);
+        snprintf(name, sizeof(name), "%zu taps, fix32_mul loop", taps[t]);
+        ref = report(name, bench_fir_scalar, BENCH_N, 0.);
+        snprintf(name, sizeof(name), "%zu taps, fix32_fir_process", taps[t]);
+        report(name, bench_fir_process, BENCH_N, ref);
+        snprintf(name, sizeof(name), "%zu taps, decimate by 4", taps[t]);
+        report(name, bench_fir_decimate, BENCH_N, ref);
+        snprintf(name, sizeof(name), "%zu taps, interpolate by 4", taps[t]);
+        report(name, bench_fir_interpolate, BENCH_N, 0.);
+    }
+}
+
+
+/**
+ * Biquad cascades of 1 to 8 sections: block processing of each structure
+ * vs. a per-sample loop of Direct Form I sections built from rounded
+ * fix32_mul() products
+ */
+#define BENCH_BIQUAD_MAX_SECTIONS 8
+
+// 2nd-order Butterworth lowpass at 0.1 times the sampling rate
+static const fix32_biquad_coeffs biquad_section = {
+    (int32_t)(0.0674552738890719 * (1 << 30)),
+    (int32_t)(0.1349105477781438 * (1 << 30)),
+    (int32_t)(0.0674552738890719 * (1 << 30)),
+    (int32_t)(-1.1429805025399011 * (1 << 30)),
+    (int32_t)(0.4128015980961886 * (1 << 30))
+};
+static fix32_biquad_coeffs biquad_coeffs[BENCH_BIQUAD_MAX_SECTIONS];
+static fix32_biquad_state biquad_state[BENCH_BIQUAD_MAX_SECTIONS];
+static fix32_biquad biquad;
+
+static void bench_biquad_scalar(void)
+{
+    size_t i, k;
+    for (i = 0; i < BENCH_N; i++) {
+        int32_t x = src[i];
+        for (k = 0; k < biquad.sections; k++) {
+            const fix32_biquad_coeffs *c = &biquad_coeffs[k];
+            fix32_biquad_state *st = &biquad_state[k];
+            int32_t y = fix32_mul(c->b0, x, 30) + fix32_mul(c->b1, st->x1, 30)
+                      + fix32_mul(c->b2, st->x2, 30)
+                      - fix32_mul(c->a1, st->y1, 30)
+                      - fix32_mul(c->a2, st->y2, 30);
+            st->x2 = st->x1;
+            st->x1 = x;
+            st->y2 = st->y1;
+            st->y1 = y;
+            x = y;
+        }
+        dst[i] = x;
+    }
+    bench_sink = dst[0];
+}
+
+static void bench_biquad_process(void)
+{
+    fix32_biquad_process(&biquad, src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_biquad(void)
+{
+    static const size_t sections[] = { 1, 2, 4, 8 };
+    static const char *const forms[] = { "DF1", "DF1 + EF", "DF2T" };
+    char name[64];
+    size_t k, f;
+    printf("biquad cascades (fix32biquad.h):\n");
+    bench_fill(src, BENCH_N, 29);
+    for (k = 0; k < BENCH_BIQUAD_MAX_SECTIONS; k++)
+        biquad_coeffs[k] = biquad_section;
+    for (k = 0; k < sizeof(sections) / sizeof(sections[0]); k++) {
+        double ref;
+        fix32_biquad_init(&biquad, biquad_coeffs, biquad_state, sections[k],
+                          FIX32_BIQUAD_DF1, FIX32_RHAZ, 30);
+        snprintf(name, sizeof(name), "%zu section%s, fix32_mul loop",
+                 sections[k], (sections[k] == 1) ? "" : "s");
+        ref = report(name, bench_biquad_scalar, BENCH_N, 0.);
+        for (f = 0; f < sizeof(forms) / sizeof(forms[0]); f++) {
+            fix32_biquad_init(&biquad, biquad_coeffs, biquad_state,
+                              sections[k], (fix32_biquad_form)f, FIX32_RHAZ,
+                              30);
+            snprintf(name, sizeof(name), "%zu section%s, %s", sections[k],
+                     (sections[k] == 1) ? "" : "s", forms[f]);
+            report(name, bench_biquad_process, BENCH_N, ref);
+        }
+    }
+}
+
+
+/**
+ * FFTs of 64 samples up to the largest size supported by the sine table,
+ * interleaved and split, each applied to a fresh copy of the same input; the
+ * throughput is given in samples, followed by the post-processing kernels
+ */
+#define BENCH_FFT_MAX_LOG2N 16
+
+static int32_t fft_in[2 << BENCH_FFT_MAX_LOG2N];
+static int32_t fft_buf[2 << BENCH_FFT_MAX_LOG2N];
+static int fft_log2n;
+
+static void bench_fft_interleaved(void)
+{
+    memcpy(fft_buf, fft_in, (2 << fft_log2n) * sizeof(int32_t));
+    bench_sink = fix32_fft(fft_buf, fft_log2n);
+}
+
+static void bench_fft_split(void)
+{
+    size_t half = (size_t)1 << fft_log2n;
+    memcpy(fft_buf, fft_in, (2 << fft_log2n) * sizeof(int32_t));
+    bench_sink = fix32_fft_split(fft_buf, fft_buf + half, fft_log2n);
+}
+
+static void bench_fft_magnitude(void)
+{
+    fix32_fft_magnitude(fft_in, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_fft_phase(void)
+{
+    fix32_fft_phase(fft_in, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_fft(void)
+{
+    char name[64];
+    printf("FFT (fix32fft.h):\n");
+    bench_fill(fft_in, 2 << BENCH_FFT_MAX_LOG2N, 30);
+    for (fft_log2n = 6; fft_log2n <= BENCH_FFT_MAX_LOG2N; fft_log2n += 2) {
+        size_t size = (size_t)1 << fft_log2n;
+        if (fix32_fft(fft_buf, fft_log2n) < 0) {
+            printf("  N = %zu and above: not supported by the sine table\n",
+                   size);
+            break;
+        }
+        snprintf(name, sizeof(name), "N = %zu, fix32_fft", size);
+        report(name, bench_fft_interleaved, size, 0.);
+        snprintf(name, sizeof(name), "N = %zu, fix32_fft_split", size);
+        report(name, bench_fft_split, size, 0.);
+    }
+    report("fix32_fft_magnitude", bench_fft_magnitude, BENCH_N, 0.);
+    report("fix32_fft_phase", bench_fft_phase, BENCH_N, 0.);
+}
+
+
+/**
+ * Complex kernels vs. the hand-written loops they replace: products from four
+ * rounded fix32_mul() calls and the phase from fix32_atan2() of the raw parts
+ * (values with a scaling factor of 2^30 and a magnitude below 0.5)
+ */
+static fix32_cmplx cmplx_a[BENCH_N], cmplx_b[BENCH_N], cmplx_res[BENCH_N];
+
+static void bench_cmplx_mul_scalar(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++) {
+        fix32_cmplx a = cmplx_a[i], b = cmplx_b[i];
+        cmplx_res[i].re = fix32_mul(a.re, b.re, 30)
+                        - fix32_mul(a.im, b.im, 30);
+        cmplx_res[i].im = fix32_mul(a.re, b.im, 30)
+                        + fix32_mul(a.im, b.re, 30);
+    }
+    bench_sink = cmplx_res[0].re;
+}
+
+static void bench_cmplx_mul(void)
+{
+    fix32_cmplx_mul_array(cmplx_a, cmplx_b, cmplx_res, BENCH_N, 30);
+    bench_sink = cmplx_res[0].re;
+}
+
+static void bench_cmplx_mul_gauss(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        cmplx_res[i] = fix32_cmplx_mul_gauss(cmplx_a[i], cmplx_b[i], 30);
+    bench_sink = cmplx_res[0].re;
+}
+
+static void bench_cmplx_mul_conj(void)
+{
+    fix32_cmplx_mul_conj_array(cmplx_a, cmplx_b, cmplx_res, BENCH_N, 30);
+    bench_sink = cmplx_res[0].re;
+}
+
+static void bench_cmplx_mag(void)
+{
+    fix32_cmplx_mag_array(cmplx_a, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_cmplx_phase_scalar(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        dst[i] = fix32_atan2(cmplx_a[i].im, cmplx_a[i].re, 30);
+    bench_sink = dst[0];
+}
+
+static void bench_cmplx_phase(void)
+{
+    fix32_cmplx_phase_array(cmplx_a, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_cmplx(void)
+{
+    double ref;
+    printf("complex numbers (fix32cmplx.h):\n");
+    bench_fill((int32_t *)cmplx_a, 2 * BENCH_N, 29);
+    bench_fill((int32_t *)cmplx_b, 2 * BENCH_N, 29);
+    ref = report("product, fix32_mul loop", bench_cmplx_mul_scalar, BENCH_N,
+                 0.);
+    report("fix32_cmplx_mul_array", bench_cmplx_mul, BENCH_N, ref);
+    report("fix32_cmplx_mul_gauss loop", bench_cmplx_mul_gauss, BENCH_N, ref);
+    report("fix32_cmplx_mul_conj_array", bench_cmplx_mul_conj, BENCH_N, ref);
+    report("fix32_cmplx_mag_array", bench_cmplx_mag, BENCH_N, 0.);
+    ref = report("phase, fix32_atan2 loop", bench_cmplx_phase_scalar, BENCH_N,
+                 0.);
+    report("fix32_cmplx_phase_array", bench_cmplx_phase, BENCH_N, ref);
+}
+
+
+/**
+ * FM discriminator vs. the hand-written loop it replaces, i.e. the conjugate
+ * product of consecutive samples from rounded fix32_mul() calls followed by
+ * fix32_atan2() (samples with a scaling factor of 2^30 and a magnitude below
+ * 0.5); the throughput is given in samples
+ */
+static void bench_disc_scalar(void)
+{
+    fix32_cmplx prev = cmplx_a[BENCH_N - 1];
+    size_t i;
+    for (i = 0; i < BENCH_N; i++) {
+        fix32_cmplx cur = cmplx_a[i];
+        int32_t re = fix32_mul(cur.re, prev.re, 30)
+                   + fix32_mul(cur.im, prev.im, 30),
+                im = fix32_mul(cur.im, prev.re, 30)
+                   - fix32_mul(cur.re, prev.im, 30);
+        dst[i] = fix32_atan2(im, re, 30);
+        prev = cur;
+    }
+    bench_sink = dst[0];
+}
+
+static fix32_cmplx_disc disc;
+
+static void bench_disc(void)
+{
+    fix32_cmplx_disc_process(&disc, cmplx_a, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_fm(void)
+{
+    double ref;
+    printf("FM discriminator (fix32cmplx.h):\n");
+    bench_fill((int32_t *)cmplx_a, 2 * BENCH_N, 29);
+    fix32_cmplx_disc_init(&disc);
+    ref = report("fix32_mul + fix32_atan2 loop", bench_disc_scalar, BENCH_N,
+                 0.);
+    report("fix32_cmplx_disc_process", bench_disc, BENCH_N, ref);
+}
+
+
+/**
+ * Oscillator and phase unwrapping: the table-based NCO vs. a hand-written
+ * oscillator accumulating the phase in radians with a scaling factor of 2^28
+ * and calling fix32_sincos()
+ */
+static fix32_nco nco;
+static fix32_unwrap unwrap;
+static int64_t unwrap_out[BENCH_N];
+
+static void bench_nco_scalar(void)
+{
+    const int32_t pi = 843314857, freq = 12345678; // pi * 2^28, ~0.046 rad
+    static int32_t phase = 0;
+    size_t i;
+    for (i = 0; i < BENCH_N; i++) {
+        fix32_sincos(phase, &cmplx_res[i].im, &cmplx_res[i].re);
+        phase += freq;
+        if (phase > pi)
+            phase -= 2 * pi;
+    }
+    bench_sink = cmplx_res[0].re;
+}
+
+static void bench_nco_process(void)
+{
+    fix32_nco_process(&nco, cmplx_res, BENCH_N);
+    bench_sink = cmplx_res[0].re;
+}
+
+static void bench_unwrap(void)
+{
+    fix32_unwrap_process(&unwrap, src, unwrap_out, BENCH_N);
+    bench_sink = (int32_t)unwrap_out[0];
+}
+
+static void bench_nco(void)
+{
+    double ref;
+    size_t i;
+    printf("oscillator and phase unwrapping (fix32nco.h):\n");
+    fix32_nco_init(&nco, fix32_rad_to_turn(12345678), 0);
+    ref = report("fix32_sincos oscillator", bench_nco_scalar, BENCH_N, 0.);
+    report("fix32_nco_process", bench_nco_process, BENCH_N, ref);
+
+    // phases of a signal rotating by up to 2 rad per sample
+    fix32_unwrap_init(&unwrap);
+    bench_fill(dst, BENCH_N, 29);
+    src[0] = 0;
+    for (i = 1; i < BENCH_N; i++)
+        src[i] = fix32_turn_to_rad(fix32_rad_to_turn(src[i - 1])
+                                   + fix32_rad_to_turn(dst[i]));
+    report("fix32_unwrap_process", bench_unwrap, BENCH_N, 0.);
+}
+
+
+/**
+ * C++ fixed point type: a cubic polynomial evaluated with 'fix32::fixed<>'
+ * (in 'fix32bench_cpp.cpp') vs. the same computation with fix32_mul_rhaz()
+ * calls and literal shift amounts, which should take the same time
+ */
+void fix32bench_poly_fixed(const int32_t *x, int32_t *res, size_t count);
+
+static void fix32bench_poly_c(const int32_t *x, int32_t *res, size_t count)
+{
+    const int32_t c0 = 0x10000000, c1 = -0x20000000, c2 = 0x08000000,
+                  c3 = 0x04000000;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        int32_t v = x[i], p = c3;
+        p = fix32_mul_rhaz(p, v, 30) + c2;
+        p = fix32_mul_rhaz(p, v, 30) + c1;
+        p = fix32_mul_rhaz(p, v, 30) + c0;
+        res[i] = p;
+    }
+}
+
+static void bench_poly_c(void)
+{
+    fix32bench_poly_c(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_poly_fixed(void)
+{
+    fix32bench_poly_fixed(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_fixed(void)
+{
+    double ref;
+    printf("C++ fixed point type (fix32fixed.hpp):\n");
+    bench_fill(src, BENCH_N, 30);
+    ref = report("cubic polynomial, fix32_mul_rhaz", bench_poly_c, BENCH_N,
+                 0.);
+    report("cubic polynomial, fix32::fixed<>", bench_poly_fixed, BENCH_N,
+           ref);
+}
+
+
+/**
+ * Header-only mode: loops of fix32_invsqrt(), fix32_atan2() and
+ * fix32_sincos() with constant scaling factors calling the library vs. the
+ * same loops in 'fix32bench_inline.c', compiled with FIX32MATH_INLINE
+ */
+void fix32bench_invsqrt_inline(const int32_t *x, int32_t *res, size_t count);
+void fix32bench_atan2_inline(const int32_t *y, const int32_t *x,
+                             int32_t *res, size_t count);
+void fix32bench_sincos_inline(const int32_t *angle, int32_t *res,
+                              size_t count);
+
+static void bench_invsqrt_linked(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++) {
+        int scale = 30;
+        dst[i] = (int32_t)fix32_invsqrt((uint32_t)src[i], &scale) + scale;
+    }
+    bench_sink = dst[0];
+}
+
+static void bench_invsqrt_inline(void)
+{
+    fix32bench_invsqrt_inline(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_atan2_linked(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        dst[i] = fix32_atan2(src[i], src[BENCH_N + i], 30);
+    bench_sink = dst[0];
+}
+
+static void bench_atan2_inline(void)
+{
+    fix32bench_atan2_inline(src, src + BENCH_N, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_sincos_linked(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++) {
+        int32_t s, c;
+        fix32_sincos(src[i], &s, &c);
+        dst[i] = s + c;
+    }
+    bench_sink = dst[0];
+}
+
+static void bench_sincos_inline(void)
+{
+    fix32bench_sincos_inline(src, dst, BENCH_N);
+    bench_sink = dst[0];
+}
+
+static void bench_inline(void)
+{
+    double ref;
+    size_t i;
+    printf("header-only mode (FIX32MATH_INLINE):\n");
+
+    // positive values for the inverse square root, angles within [-pi, pi]
+    bench_fill(src, 2 * BENCH_N, 29);
+    for (i = 0; i < BENCH_N; i++)
+        src[i] = (src[i] & 0x3FFFFFFF) | 1;
+    ref = report("fix32_invsqrt, linked", bench_invsqrt_linked, BENCH_N, 0.);
+    report("fix32_invsqrt, inline", bench_invsqrt_inline, BENCH_N, ref);
+    bench_fill(src, 2 * BENCH_N, 30);
+    ref = report("fix32_atan2, linked", bench_atan2_linked, BENCH_N, 0.);
+    report("fix32_atan2, inline", bench_atan2_inline, BENCH_N, ref);
+    bench_fill(src, BENCH_N, 29);
+    ref = report("fix32_sincos, linked", bench_sincos_linked, BENCH_N, 0.);
+    report("fix32_sincos, inline", bench_sincos_inline, BENCH_N, ref);
+}
+
+
+/**
+ * fix32_atan2() for inputs in several fixed point formats, i.e. magnitudes
+ * around 2^15 (Q15), 2^24 (Q24) and 2^31 (Q31): the run time does not depend
+ * on the format, hence versions specialized per scale would not be faster
+ */
+static void bench_atan2_scale(void)
+{
+    size_t i;
+    for (i = 0; i < BENCH_N; i++)
+        dst[i] = fix32_atan2(src[i], src[BENCH_N + i], 0);
+    bench_sink = dst[0];
+}
+
+static void bench_atan2(void)
+{
+    static const int bits[] = { 15, 24, 31 };
+    char name[64];
+    double ref = 0.;
+    size_t k;
+    printf("atan2 per input format (fix32base.h):\n");
+    for (k = 0; k < sizeof(bits) / sizeof(bits[0]); k++) {
+        bench_fill(src, 2 * BENCH_N, bits[k]);
+        snprintf(name, sizeof(name), "fix32_atan2, Q%d inputs", bits[k]);
+        if (k == 0)
+            ref = report(name, bench_atan2_scale, BENCH_N, 0.);
+        else
+            report(name, bench_atan2_scale, BENCH_N, ref);
+    }
+}
+
+
+/**
+ * Parallel batched kernels with 1 thread up to one thread per online
+ * processor (doubling the number of threads) on batches much larger than the
+ * caches; the speedup is relative to a single thread
+ */
+#define BENCH_PAR_N ((size_t)1 << 22)
+
+static uint32_t *par_in;
+static int32_t *par_out;
+
+static void bench_par_invsqrt(void)
+{
+    fix32_par_invsqrt_array(par_in, par_out, BENCH_PAR_N, 30, 16);
+    bench_sink = par_out[0];
+}
+
+static void bench_par_phase(void)
+{
+    fix32_par_cmplx_phase_array((const fix32_cmplx *)par_in, par_out,
+                                BENCH_PAR_N / 2);
+    bench_sink = par_out[0];
+}
+
+static void bench_par(void)
+{
+    long procs = sysconf(_SC_NPROCESSORS_ONLN);
+    double ref_invsqrt = 0., ref_phase = 0.;
+    char name[64];
+    unsigned threads = 1;
+    size_t i;
+    printf("parallel batched kernels (fix32par.h), %ld processors:\n",
+           procs);
+
+    par_in  = malloc(BENCH_PAR_N * sizeof(uint32_t));
+    par_out = malloc(BENCH_PAR_N * sizeof(int32_t));
+    if (par_in == NULL || par_out == NULL) {
+        printf("  out of memory\n");
+        free(par_in);
+        free(par_out);
+        return;
+    }
+    bench_fill((int32_t *)par_in, BENCH_PAR_N, 30);
+    for (i = 0; i < BENCH_PAR_N; i++)
+        par_in[i] |= 1;
+
+    for (;;) {
+        if (fix32_par_init(threads) < 0) {
+            printf("  %u threads: could not be created\n", threads);
+            break;
+        }
+        snprintf(name, sizeof(name), "%u thread%s, invsqrt_array", threads,
+                 (threads == 1) ? "" : "s");
+        if (threads == 1)
+            ref_invsqrt = report(name, bench_par_invsqrt, BENCH_PAR_N, 0.);
+        else
+            report(name, bench_par_invsqrt, BENCH_PAR_N, ref_invsqrt);
+        snprintf(name, sizeof(name), "%u thread%s, cmplx_phase_array",
+                 threads, (threads == 1) ? "" : "s");
+        if (threads == 1)
+            ref_phase = report(name, bench_par_phase, BENCH_PAR_N / 2, 0.);
+        else
+            report(name, bench_par_phase, BENCH_PAR_N / 2, ref_phase);
+        fix32_par_shutdown();
+
+        if (threads >= procs)
+            break;
+        threads = (2 * threads < procs) ? 2 * threads : (unsigned)procs;
+    }
+    free(par_in);
+    free(par_out);
+}
+
+
+int main(void)
+{
+    bench_vec();
+    bench_quat();
+    bench_dot();
+    bench_fir();
+    bench_biquad();
+    bench_fft();
+    bench_cmplx();
+    bench_fm();
+    bench_nco();
+    bench_fixed();
+    bench_inline();
+    bench_atan2();
+    bench_par();
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * C++ part of the benchmarks for libfix32math ('make bench'): kernels written
+ * with 'fix32::fixed<>', timed by 'tools/fix32bench.c' against the same
+ * kernels written with the C functions.
+ */
+
+#include <stddef.h>
+
+#include "fix32fixed.hpp"
+
+extern "C" {
+void fix32bench_poly_fixed(const int32_t *x, int32_t *res, size_t count);
+}
+
+
+/**
+ * Evaluate the cubic polynomial of 'fix32bench_poly_c()' in 'fix32bench.c'
+ * with Horner's method for 'count' values with a scaling factor of 2^30.
+ */
+void fix32bench_poly_fixed(const int32_t *x, int32_t *res, size_t count)
+{
+    typedef fix32::fixed<2, 30> q30;
+    const q30 c0 = q30::from_raw(0x10000000), c1 = q30::from_raw(-0x20000000),
+              c2 = q30::from_raw(0x08000000), c3 = q30::from_raw(0x04000000);
+    size_t i;
+    for (i = 0; i < count; i++) {
+        q30 v = q30::from_raw(x[i]), p = c3;
+        p *= v;
+        p += c2;
+        p *= v;
+        p += c1;
+        p *= v;
+        p += c0;
+        res[i] = p.raw();
+    }
+}
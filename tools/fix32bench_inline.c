@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Part of the benchmarks for libfix32math ('make bench') compiled with
+ * FIX32MATH_INLINE: the same loops as the header-only benchmarks in
+ * 'tools/fix32bench.c', but with the scalar functions inlined and thus
+ * specialized for the constant scaling factors.
+ */
+
+#include <stddef.h>
+
+#define FIX32MATH_INLINE
+#include "fix32math.h"
+
+void fix32bench_invsqrt_inline(const int32_t *x, int32_t *res, size_t count);
+void fix32bench_atan2_inline(const int32_t *y, const int32_t *x,
+                             int32_t *res, size_t count);
+void fix32bench_sincos_inline(const int32_t *angle, int32_t *res,
+                              size_t count);
+
+
+void fix32bench_invsqrt_inline(const int32_t *x, int32_t *res, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        int scale = 30;
+        res[i] = (int32_t)fix32_invsqrt((uint32_t)x[i], &scale) + scale;
+    }
+}
+
+void fix32bench_atan2_inline(const int32_t *y, const int32_t *x,
+                             int32_t *res, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        res[i] = fix32_atan2(y[i], x[i], 30);
+}
+
+void fix32bench_sincos_inline(const int32_t *angle, int32_t *res,
+                              size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        int32_t s, c;
+        fix32_sincos(angle[i], &s, &c);
+        res[i] = s + c;
+    }
+}
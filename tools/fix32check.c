@@ -0,0 +1,1562 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Regression checks for libfix32math
+ *
+ * Runs a few corner cases of the library (such as full-scale inputs) against
+ * floating point references and reports any deviation beyond the documented
+ * accuracy.  Runs on the build host ('make check').
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fix32math.h"
+#include "fix15math.h"
+#include "fix32batch.h"
+#include "fix32bfp.h"
+#include "fix32biquad.h"
+#include "fix32cmplx.h"
+#include "fix32conv.h"
+#include "fix32fft.h"
+#include "fix32fir.h"
+#include "fix32mat.h"
+#include "fix32nco.h"
+#include "fix32par.h"
+#include "fix32quat.h"
+#include "fix32str.h"
+#include "fix32vec.h"
+#include "fix64math.h"
+
+// size of the sine table (see the Makefile)
+#ifndef FIX32_SINTAB_BITS
+#define FIX32_SINTAB_BITS 12
+#endif
+
+
+static int failures = 0;
+
+/**
+ * Pseudo-random value in [-2^bits, 2^bits) (linear congruential generator)
+ */
+static int32_t check_rand(int bits)
+{
+    static uint32_t state = 1;
+    state = state * 1664525u + 1013904223u;
+    return (int32_t)state >> (31 - bits);
+}
+
+/**
+ * Report a failed check if 'err' exceeds 'tol'
+ */
+static void check(const char *name, double err, double tol)
+{
+    if (err > tol) {
+        printf("FAIL %s: error %g exceeds %g\n", name, err, tol);
+        failures++;
+    }
+}
+
+
+/**
+ * FFT of full-scale input with twiddle factors of 45 degrees, which maximizes
+ * the growth within a butterfly
+ */
+static void check_fft_full_scale(void)
+{
+    enum { LOG2N = 3, N = 1 << LOG2N };
+    const double pi = 3.14159265358979323846;
+    const int32_t full = INT32_MAX;
+    static const int rot_re[4] = { 1, 0, -1, 0 }, rot_im[4] = { 0, 1, 0, -1 };
+
+    // x[2k] = M i^k and x[2k+1] = M (1 + i) i^k
+    int32_t buf[2 * N];
+    int k;
+    for (k = 0; k < N / 2; k++) {
+        int r = rot_re[k % 4], i = rot_im[k % 4];
+        buf[4 * k]     = full * r;
+        buf[4 * k + 1] = full * i;
+        buf[4 * k + 2] = full * (r - i);
+        buf[4 * k + 3] = full * (r + i);
+    }
+
+    double in_re[N], in_im[N];
+    for (k = 0; k < N; k++) {
+        in_re[k] = buf[2 * k];
+        in_im[k] = buf[2 * k + 1];
+    }
+
+    int exponent = fix32_fft(buf, LOG2N);
+    double max_err = 0.;
+    for (k = 0; k < N; k++) {
+        double ref_re = 0., ref_im = 0.;
+        int j;
+        for (j = 0; j < N; j++) {
+            double arg = -2. * pi * j * k / N;
+            ref_re += in_re[j] * cos(arg) - in_im[j] * sin(arg);
+            ref_im += in_re[j] * sin(arg) + in_im[j] * cos(arg);
+        }
+        double err_re = fabs(ldexp(buf[2 * k], exponent) - ref_re),
+               err_im = fabs(ldexp(buf[2 * k + 1], exponent) - ref_im);
+        max_err = fmax(max_err, fmax(err_re, err_im));
+    }
+    // relative to the full-scale input
+    check("fft full scale", max_err / full, 1e-6);
+}
+
+
+
+/**
+ * FFT of random near full-scale input of 2 to 1024 samples (or up to the
+ * largest size supported by the sine table) against a DFT in double
+ * precision, with an error of at most 1 LSB of the block-scaled output per
+ * stage; both layouts must yield the same output and block exponent.  The
+ * inverse FFT must restore the input within 2 LSBs of its output per stage.
+ */
+static void check_fft(void)
+{
+    enum { MAX_LOG2N = 10, MAX_N = 1 << MAX_LOG2N };
+    const double pi = 3.14159265358979323846;
+    static int32_t buf[2 * MAX_N], re[MAX_N], im[MAX_N];
+    static double in_re[MAX_N], in_im[MAX_N], cos_tab[MAX_N],
+                  sin_tab[MAX_N];
+    double max_err = 0., max_err_inv = 0., mismatch = 0.;
+    int log2n, k, j;
+    for (log2n = 1; log2n <= MAX_LOG2N; log2n++) {
+        int n = 1 << log2n;
+        for (k = 0; k < n; k++) {
+            buf[2 * k]     = re[k] = check_rand(30);
+            buf[2 * k + 1] = im[k] = check_rand(30);
+            in_re[k] = re[k];
+            in_im[k] = im[k];
+            cos_tab[k] = cos(2. * pi * k / n);
+            sin_tab[k] = sin(2. * pi * k / n);
+        }
+
+        int exponent = fix32_fft(buf, log2n);
+        if (exponent < 0)
+            break;
+        mismatch += fix32_fft_split(re, im, log2n) != exponent;
+        for (k = 0; k < n; k++) {
+            double ref_re = 0., ref_im = 0.;
+            for (j = 0; j < n; j++) {
+                int m = (int)(((long)j * k) % n);
+                ref_re += in_re[j] * cos_tab[m] + in_im[j] * sin_tab[m];
+                ref_im += in_im[j] * cos_tab[m] - in_re[j] * sin_tab[m];
+            }
+            double err_re = fabs(ldexp(buf[2 * k], exponent) - ref_re),
+                   err_im = fabs(ldexp(buf[2 * k + 1], exponent) - ref_im);
+            max_err = fmax(max_err, ldexp(fmax(err_re, err_im), -exponent)
+                                    / log2n);
+            mismatch += (re[k] != buf[2 * k]) + (im[k] != buf[2 * k + 1]);
+        }
+
+        // the round trip scales by N, i.e. by 2^-log2n after normalization
+        int exponent_inv = fix32_ifft(buf, log2n) + exponent - log2n;
+        mismatch += fix32_ifft_split(re, im, log2n) + exponent - log2n
+                    != exponent_inv;
+        for (k = 0; k < n; k++) {
+            double err_re = fabs(ldexp(buf[2 * k], exponent_inv) - in_re[k]),
+                   err_im = fabs(ldexp(buf[2 * k + 1], exponent_inv)
+                                 - in_im[k]);
+            max_err_inv = fmax(max_err_inv,
+                               ldexp(fmax(err_re, err_im), -exponent_inv)
+                               / log2n);
+            mismatch += (re[k] != buf[2 * k]) + (im[k] != buf[2 * k + 1]);
+        }
+    }
+    check("fft vs dft", max_err, 1.);
+    check("ifft round trip", max_err_inv, 2.);
+    check("fft split vs interleaved", mismatch, 0.);
+}
+
+/**
+ * Quaternion rotation of a vector with components at the documented limit,
+ * for which 2 * (u x v) exceeds 32 bits
+ */
+static void check_quat_rotate_limit(void)
+{
+    // rotation by pi about (0, 1, 1) / sqrt(2)
+    const int32_t half_sqrt2 = 759250125; // sqrt(2) / 2 * 2^30
+    fix32_quat q = { 0, 0, half_sqrt2, half_sqrt2 };
+    int32_t v[3] = { 0, -(1 << 30), 1 << 30 }, res[3];
+    fix32_quat_rotate(&q, v, res);
+
+    double err = fabs((double)res[0]) + fabs(res[1] - (double)(1 << 30))
+               + fabs(res[2] + (double)(1 << 30));
+    check("quat rotate limit", err / (1 << 30), 1e-6);
+}
+
+
+/**
+ * Inverse of a matrix whose inverse is too small for the scaling factor, i.e.
+ * the reciprocal of the determinant has a scaling factor beyond 62
+ */
+static void check_mat_inverse_underflow(void)
+{
+    int32_t a[4] = { 1 << 20, 0, 0, 1 << 20 }, res[4] = { 1, 1, 1, 1 };
+    int ret = fix32_mat2_inverse(a, res, 0);
+
+    double err = (ret != 0) + fabs((double)res[0]) + fabs((double)res[1])
+               + fabs((double)res[2]) + fabs((double)res[3]);
+    check("mat inverse underflow", err, 0.);
+}
+
+
+/**
+ * FIR filter without coefficients, which must be rejected by the
+ * initialization instead of indexing the delay line with taps - 1
+ */
+static void check_fir_zero_taps(void)
+{
+    fix32_fir fir = { 0 };
+    int32_t coeffs[1] = { 1 }, delay[2] = { 0, 0 };
+    int ret = fix32_fir_init(&fir, coeffs, 0, delay, 0);
+
+    double err = (ret != -1) + (fir.delay != NULL);
+    check("fir zero taps", err, 0.);
+}
+
+
+
+/**
+ * Direct convolution of 'count' samples with 'taps' coefficients as a
+ * reference for the FIR engine; 'rev' receives the input in reverse order
+ * followed by 'taps' zeros, such that each window starts at rev[count-1-k]
+ */
+static void check_fir_ref(const int32_t *coeffs, size_t taps, int n,
+                          const int32_t *in, int32_t *rev, int32_t *out,
+                          size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+        rev[count - 1 - i] = in[i];
+    for (i = 0; i < taps; i++)
+        rev[count + i] = 0;
+    for (i = 0; i < count; i++)
+        out[i] = fix32_dot(coeffs, rev + count - 1 - i, taps, n);
+}
+
+/**
+ * FIR filtering, decimation and interpolation in blocks of odd sizes (such
+ * that the decimation phase carries across blocks) against a direct
+ * convolution of the (zero-stuffed) input, which must match bit by bit
+ */
+static void check_fir(void)
+{
+    enum { TAPS = 13, N = 200, BLOCK = 7, MAX_FACTOR = 4 };
+    static int32_t coeffs[TAPS], delay[2 * TAPS], in[N], up[MAX_FACTOR * N],
+                   rev[MAX_FACTOR * N + TAPS], ref[MAX_FACTOR * N],
+                   out[MAX_FACTOR * N];
+    fix32_fir fir;
+    double err = 0.;
+    size_t i, pos, factor, out_count;
+    for (i = 0; i < TAPS; i++)
+        coeffs[i] = check_rand(28);
+    for (i = 0; i < N; i++)
+        in[i] = check_rand(28);
+
+    // filtering in place
+    check_fir_ref(coeffs, TAPS, 31, in, rev, ref, N);
+    fix32_fir_init(&fir, coeffs, TAPS, delay, 31);
+    for (i = 0; i < N; i++)
+        out[i] = in[i];
+    for (pos = 0; pos < N; pos += BLOCK)
+        fix32_fir_process(&fir, out + pos, out + pos,
+                          (N - pos < BLOCK) ? N - pos : BLOCK);
+    for (i = 0; i < N; i++)
+        err += out[i] != ref[i];
+
+    // decimation keeps every factor-th output, starting with the last sample
+    // of the first period
+    for (factor = 1; factor <= MAX_FACTOR + 1; factor++) {
+        fix32_fir_reset(&fir);
+        out_count = 0;
+        for (pos = 0; pos < N; pos += BLOCK)
+            out_count += fix32_fir_decimate(&fir, in + pos, out + out_count,
+                                            (N - pos < BLOCK) ? N - pos
+                                                              : BLOCK,
+                                            factor);
+        err += out_count != N / factor;
+        for (i = 0; i < out_count && i < N / factor; i++)
+            err += out[i] != ref[factor * i + factor - 1];
+    }
+
+    // a factor of 0 leaves the filter untouched
+    pos = fir.pos;
+    err += fix32_fir_decimate(&fir, in, out, N, 0) != 0;
+    err += fir.pos != pos;
+
+    // interpolation equals filtering of the zero-stuffed input
+    for (factor = 1; factor <= MAX_FACTOR; factor++) {
+        for (i = 0; i < factor * N; i++)
+            up[i] = (i % factor == 0) ? in[i / factor] : 0;
+        check_fir_ref(coeffs, TAPS, 31, up, rev, ref, factor * N);
+        fix32_fir_reset(&fir);
+        for (pos = 0; pos < N; pos += BLOCK)
+            fix32_fir_interpolate(&fir, in + pos, out + factor * pos,
+                                  (N - pos < BLOCK) ? N - pos : BLOCK,
+                                  factor);
+        for (i = 0; i < factor * N; i++)
+            err += out[i] != ref[i];
+    }
+    check("fir process/decimate/interpolate", err, 0.);
+}
+
+
+/**
+ * Reference rounding of a 64-bit accumulator to a scaling factor lower by
+ * 2^n (n >= 1) with one of the flavours of 'fix32_rounding'
+ */
+static int64_t check_round_64(int64_t acc, int n, fix32_rounding rounding)
+{
+    int64_t q = acc >> n, rem = acc - q * (1LL << n), half = 1LL << (n - 1);
+    if (rem != half)
+        return q + (rem > half);
+    switch (rounding) {
+    case FIX32_RHU:  return q + 1;
+    case FIX32_RHD:  return q;
+    case FIX32_RHAZ: return q + (acc > 0);
+    default:         return q + (acc < 0);
+    }
+}
+
+/**
+ * Biquad cascades of all structures and rounding flavours against a sample
+ * by sample evaluation of the difference equation, which must match bit by
+ * bit; the Direct Form II transposed keeps its state exactly and thus yields
+ * the same output as the Direct Form I without error feedback.  A cascade
+ * of 0 sections passes the input through.
+ */
+static void check_biquad(void)
+{
+    enum { SECTIONS = 4, N = 500, BLOCK = 37 };
+    // stable sections (n = 30); the coefficients of the first one are
+    // multiples of 2^28, such that a quarter of its outputs are ties, which
+    // tell the rounding flavours apart
+    static const fix32_biquad_coeffs coeffs[SECTIONS] = {
+        {  268435456,  536870912,  268435456,  -536870912,  268435456 },
+        {  214748365,  429496730,  214748365, -1288490189,  536870912 },
+        {  107374182,          0, -107374182,  -858993459,  751619277 },
+        {   53687091,  107374182,   53687091, -1825361101,  880803840 }
+    };
+    static int32_t in[N], out[N];
+    fix32_biquad_state state[SECTIONS];
+    fix32_biquad bq;
+    double err = 0.;
+    int form, rounding;
+    size_t i, pos, k;
+    for (i = 0; i < N; i++)
+        in[i] = check_rand(20);
+
+    for (form = FIX32_BIQUAD_DF1; form <= FIX32_BIQUAD_DF2T; form++) {
+        for (rounding = FIX32_RHU; rounding <= FIX32_RHTZ; rounding++) {
+            struct { int32_t x1, x2, y1, y2; int64_t err; } ref[SECTIONS];
+            for (k = 0; k < SECTIONS; k++) {
+                ref[k].x1 = ref[k].x2 = ref[k].y1 = ref[k].y2 = 0;
+                ref[k].err = 0;
+            }
+
+            fix32_biquad_init(&bq, coeffs, state, SECTIONS,
+                              (fix32_biquad_form)form,
+                              (fix32_rounding)rounding, 30);
+            for (pos = 0; pos < N; pos += BLOCK)
+                fix32_biquad_process(&bq, in + pos, out + pos,
+                                     (N - pos < BLOCK) ? N - pos : BLOCK);
+
+            for (i = 0; i < N; i++) {
+                int32_t x = in[i];
+                for (k = 0; k < SECTIONS; k++) {
+                    const fix32_biquad_coeffs *c = &coeffs[k];
+                    int64_t acc = ref[k].err + (int64_t)c->b0 * x
+                                + (int64_t)c->b1 * ref[k].x1
+                                + (int64_t)c->b2 * ref[k].x2
+                                - (int64_t)c->a1 * ref[k].y1
+                                - (int64_t)c->a2 * ref[k].y2;
+                    int32_t y = (int32_t)check_round_64(
+                        acc, 30, (fix32_rounding)rounding);
+                    if (form == FIX32_BIQUAD_DF1_EF)
+                        ref[k].err = acc - (int64_t)y * (1LL << 30);
+                    ref[k].x2 = ref[k].x1;
+                    ref[k].x1 = x;
+                    ref[k].y2 = ref[k].y1;
+                    ref[k].y1 = y;
+                    x = y;
+                }
+                err += out[i] != x;
+            }
+        }
+    }
+
+    fix32_biquad_init(&bq, coeffs, state, 0, FIX32_BIQUAD_DF1, FIX32_RHAZ,
+                      30);
+    fix32_biquad_process(&bq, in, out, N);
+    for (i = 0; i < N; i++)
+        err += out[i] != in[i];
+    check("biquad forms and roundings", err, 0.);
+}
+
+/**
+ * Normalization of random vectors of 2, 3 and 4 components of any magnitude
+ * in both layouts (with the relative accuracy of 'fix32_invsqrt()') and of
+ * zero vectors
+ */
+static void check_vec_normalize(void)
+{
+    enum { N = 1000 };
+    static int32_t aos[4 * N], soa[4 * N], res_aos[4 * N], res_soa[4 * N];
+    double max_err = 0.;
+    int dim, i, d;
+    for (dim = 2; dim <= 4; dim++) {
+        // the first vector is a zero vector
+        for (i = 0; i < N; i++) {
+            int bits = i % 31;
+            for (d = 0; d < dim; d++)
+                aos[dim * i + d] = soa[d * N + i] = i ? check_rand(bits) : 0;
+        }
+
+        switch (dim) {
+            case 2:
+                fix32_vec2_normalize(aos, res_aos, N);
+                fix32_vec2_normalize_soa(soa, soa + N, res_soa,
+                                         res_soa + N, N);
+                break;
+            case 3:
+                fix32_vec3_normalize(aos, res_aos, N);
+                fix32_vec3_normalize_soa(soa, soa + N, soa + 2 * N, res_soa,
+                                         res_soa + N, res_soa + 2 * N, N);
+                break;
+            default:
+                fix32_vec4_normalize(aos, res_aos, N);
+                fix32_vec4_normalize_soa(soa, soa + N, soa + 2 * N,
+                                         soa + 3 * N, res_soa, res_soa + N,
+                                         res_soa + 2 * N, res_soa + 3 * N, N);
+        }
+
+        for (i = 0; i < N; i++) {
+            double len = 0.;
+            for (d = 0; d < dim; d++)
+                len += (double)aos[dim * i + d] * aos[dim * i + d];
+            len = sqrt(len);
+            for (d = 0; d < dim; d++) {
+                double ref = (len > 0.) ? aos[dim * i + d] / len : 0.,
+                       got = ldexp(res_aos[dim * i + d], -30);
+                max_err = fmax(max_err, fabs(got - ref));
+                max_err = fmax(max_err, (double)(res_aos[dim * i + d]
+                                                 != res_soa[d * N + i]));
+            }
+        }
+    }
+    check("vec normalize", max_err, 1e-4);
+}
+
+
+/**
+ * Hamilton product of random quaternions against a double reference (one
+ * rounding per component), renormalization of nearly unit quaternions and
+ * slerp at both ends of the interval
+ */
+static void check_quat(void)
+{
+    double max_err = 0.;
+    int i, k;
+    for (i = 0; i < 1000; i++) {
+        fix32_quat a = { check_rand(29), check_rand(29), check_rand(29),
+                         check_rand(29) },
+                   b = { check_rand(29), check_rand(29), check_rand(29),
+                         check_rand(29) }, r;
+        fix32_quat_mul(&a, &b, &r, 30);
+        double ref[4] = {
+            ((double)a.w * b.w - (double)a.x * b.x - (double)a.y * b.y
+             - (double)a.z * b.z) / (1 << 30),
+            ((double)a.w * b.x + (double)a.x * b.w + (double)a.y * b.z
+             - (double)a.z * b.y) / (1 << 30),
+            ((double)a.w * b.y - (double)a.x * b.z + (double)a.y * b.w
+             + (double)a.z * b.x) / (1 << 30),
+            ((double)a.w * b.z + (double)a.x * b.y - (double)a.y * b.x
+             + (double)a.z * b.w) / (1 << 30)
+        };
+        int32_t got[4] = { r.w, r.x, r.y, r.z };
+        for (k = 0; k < 4; k++)
+            max_err = fmax(max_err, fabs(got[k] - ref[k]));
+    }
+    check("quat mul", max_err, 0.5);
+
+    // renormalization of a unit quaternion scaled by 1.005
+    max_err = 0.;
+    for (i = 0; i < 1000; i++) {
+        fix32_quat q = { check_rand(29), check_rand(29), check_rand(29),
+                         check_rand(29) }, u, r;
+        fix32_quat_normalize(&q, &u);
+        q.w = (int32_t)(u.w * 1.005);
+        q.x = (int32_t)(u.x * 1.005);
+        q.y = (int32_t)(u.y * 1.005);
+        q.z = (int32_t)(u.z * 1.005);
+        fix32_quat_renormalize(&q, &r);
+        double norm = sqrt((double)r.w * r.w + (double)r.x * r.x
+                           + (double)r.y * r.y + (double)r.z * r.z);
+        max_err = fmax(max_err, fabs(norm / (1 << 30) - 1.));
+    }
+    // the error of one Newton step is about 1.5 (|q|^2 - 1)^2
+    check("quat renormalize", max_err, 2e-4);
+
+    // slerp at t = 0 and t = 1 returns the end points
+    max_err = 0.;
+    for (i = 0; i < 100; i++) {
+        fix32_quat q[2], r[2];
+        for (k = 0; k < 2; k++) {
+            fix32_quat v = { check_rand(29), check_rand(29), check_rand(29),
+                             check_rand(29) };
+            fix32_quat_normalize(&v, &q[k]);
+        }
+        // along the shorter arc
+        if ((double)q[0].w * q[1].w + (double)q[0].x * q[1].x
+            + (double)q[0].y * q[1].y + (double)q[0].z * q[1].z < 0.) {
+            q[1].w = -q[1].w;
+            q[1].x = -q[1].x;
+            q[1].y = -q[1].y;
+            q[1].z = -q[1].z;
+        }
+        fix32_quat_slerp(&q[0], &q[1], 0, &r[0]);
+        fix32_quat_slerp(&q[0], &q[1], 1 << 30, &r[1]);
+        for (k = 0; k < 2; k++) {
+            double err = fabs((double)r[k].w - q[k].w)
+                       + fabs((double)r[k].x - q[k].x)
+                       + fabs((double)r[k].y - q[k].y)
+                       + fabs((double)r[k].z - q[k].z);
+            max_err = fmax(max_err, err / (1 << 30));
+        }
+    }
+    check("quat slerp end points", max_err, 1e-3);
+}
+
+
+/**
+ * Inverse of random diagonally dominant 3x3 matrices (the product with the
+ * matrix must be the identity within the precision of the scaling factor),
+ * of a singular matrix (must be rejected) and the 3x3 product against a
+ * double reference (one rounding per element)
+ */
+static void check_mat3(void)
+{
+    const int n = 24;
+    double max_err = 0., mul_err = 0.;
+    int i, r, c, k;
+    for (i = 0; i < 1000; i++) {
+        int32_t a[9], inv[9], b[9], prod[9];
+        for (k = 0; k < 9; k++) {
+            a[k] = check_rand(n - 2);
+            b[k] = check_rand(n);
+        }
+        a[0] += 3 << (n - 1);
+        a[4] -= 3 << (n - 1);
+        a[8] += 1 << n;
+        if (fix32_mat3_inverse(a, inv, n) != 0) {
+            max_err = 1.;
+            continue;
+        }
+        fix32_mat3_mul(a, b, prod, n);
+        for (r = 0; r < 3; r++) {
+            for (c = 0; c < 3; c++) {
+                double sum = 0., ref = 0.;
+                for (k = 0; k < 3; k++) {
+                    sum += (double)a[3 * r + k] * inv[3 * k + c];
+                    ref += (double)a[3 * r + k] * b[3 * k + c];
+                }
+                ref = ldexp(ref, -n);
+                max_err = fmax(max_err, fabs(ldexp(sum, -2 * n) - (r == c)));
+                mul_err = fmax(mul_err, fabs(prod[3 * r + c] - ref));
+            }
+        }
+    }
+    check("mat3 inverse", max_err, 1e-5);
+    check("mat3 mul", mul_err, 0.5);
+
+    int32_t singular[9] = { 1 << n, 2 << n, 3 << n, 2 << n, 4 << n, 6 << n,
+                            0, 1 << n, 0 }, res[9];
+    check("mat3 inverse singular", fix32_mat3_inverse(singular, res, n) != -1,
+          0.);
+}
+
+
+#ifdef __SIZEOF_INT128__
+/**
+ * Round a 128-bit sum half away from zero to a scaling factor lower by 2^n
+ * (n >= 1) and wrap it to 32 bits, i.e. the exact result of a dot product
+ */
+static int32_t check_round_128(__int128 sum, int n)
+{
+    __int128 half = (__int128)1 << (n - 1);
+    __int128 res = (sum >= 0) ? (sum + half) >> n : -((-sum + half) >> n);
+    return (int32_t)(uint32_t)(unsigned __int128)res;
+}
+
+/**
+ * Dot products against an exact 128-bit reference: fix32_dot and the strided
+ * variant for vectors short enough for a 64-bit sum (at most 2^(63 - 2m)
+ * elements of magnitude 2^m), and fix32_dot_wide for long vectors of
+ * full-scale elements, whose sum exceeds 64 bits
+ */
+static void check_dot(void)
+{
+    enum { N = 100000 };
+    static int32_t a[N], b[N], c[N], d[N];
+    static const int n[] = { 1, 16, 31, 32, 40, 48, 56, 62 };
+    double err = 0.;
+    size_t i, count;
+    int k;
+    for (i = 0; i < N; i++) {
+        a[i] = check_rand(31);
+        b[i] = check_rand(31);
+        c[i] = a[i] >> 4;
+        d[i] = b[i] >> 4;
+    }
+    // the first half has elements of equal sign, such that the sum is large
+    for (i = 0; i < N / 2; i++)
+        b[i] = (a[i] < 0) ? -(b[i] & INT32_MAX) : (b[i] & INT32_MAX);
+
+    for (k = 0; k < (int)(sizeof(n) / sizeof(n[0])); k++) {
+        for (count = 1; count <= N; count *= 10) {
+            __int128 sum = 0;
+            for (i = 0; i < count; i++)
+                sum += (int64_t)a[i] * b[i];
+            err += fix32_dot_wide(a, b, count, n[k])
+                   != check_round_128(sum, n[k]);
+        }
+
+        // up to 2^9 elements of magnitude 2^27
+        for (count = 1; count <= 500; count += 166) {
+            __int128 sum = 0, sum_col = 0;
+            for (i = 0; i < count; i++) {
+                sum += (int64_t)c[i] * d[i];
+                sum_col += (int64_t)c[4 * i + 1] * d[i];
+            }
+            err += fix32_dot(c, d, count, n[k]) != check_round_128(sum, n[k]);
+            err += fix32_dot_strided(c + 1, 4, d, 1, count, n[k])
+                   != check_round_128(sum_col, n[k]);
+        }
+    }
+    check("dot vs int128", err, 0.);
+}
+#endif
+
+
+/**
+ * Complex products against an exact 64-bit reference (all variants must
+ * round like 'fix32_mul()' and the array variants must match the scalar
+ * functions), and magnitude and phase of random values of any magnitude
+ * against 'hypot()' and 'atan2()'
+ */
+static void check_cmplx(void)
+{
+    enum { N = 1000 };
+    static fix32_cmplx a[N], b[N], prod[N], prod_conj[N];
+    static int32_t mag[N], phase[N];
+    double mismatch = 0., max_err_mag = 0., max_err_phase = 0.;
+    int i;
+    for (i = 0; i < N; i++) {
+        int bits = i % 30;
+        a[i].re = check_rand(29);
+        a[i].im = check_rand(29);
+        b[i].re = check_rand(bits);
+        b[i].im = check_rand(bits);
+    }
+
+    fix32_cmplx_mul_array(a, b, prod, N, 29);
+    fix32_cmplx_mul_conj_array(a, b, prod_conj, N, 29);
+    for (i = 0; i < N; i++) {
+        fix32_cmplx p = fix32_cmplx_mul(a[i], b[i], 29),
+                    g = fix32_cmplx_mul_gauss(a[i], b[i], 29),
+                    c = fix32_cmplx_mul_conj(a[i], b[i], 29);
+        int64_t re_64 = (int64_t)a[i].re * b[i].re
+                      - (int64_t)a[i].im * b[i].im,
+                im_64 = (int64_t)a[i].re * b[i].im
+                      + (int64_t)a[i].im * b[i].re,
+                re_conj_64 = (int64_t)a[i].re * b[i].re
+                           + (int64_t)a[i].im * b[i].im,
+                im_conj_64 = (int64_t)a[i].im * b[i].re
+                           - (int64_t)a[i].re * b[i].im;
+        int32_t re = fix32_acc_scale_rhaz(re_64, 29),
+                im = fix32_acc_scale_rhaz(im_64, 29),
+                re_conj = fix32_acc_scale_rhaz(re_conj_64, 29),
+                im_conj = fix32_acc_scale_rhaz(im_conj_64, 29);
+        mismatch += (p.re != re) + (p.im != im) + (g.re != re) + (g.im != im)
+                  + (c.re != re_conj) + (c.im != im_conj)
+                  + (prod[i].re != re) + (prod[i].im != im)
+                  + (prod_conj[i].re != re_conj)
+                  + (prod_conj[i].im != im_conj);
+    }
+    check("cmplx products", mismatch, 0.);
+
+    // the first value is 0, whose magnitude and phase are 0
+    for (i = 0; i < N; i++) {
+        int bits = i % 31;
+        b[i].re = i ? check_rand(bits) : 0;
+        b[i].im = i ? check_rand(bits) : 0;
+    }
+    fix32_cmplx_mag_array(b, mag, N);
+    fix32_cmplx_phase_array(b, phase, N);
+    for (i = 0; i < N; i++) {
+        double ref_mag = hypot(b[i].re, b[i].im),
+               ref_phase = atan2(b[i].im, b[i].re);
+        if (i == 0) {
+            mismatch += (mag[i] != 0) + (phase[i] != 0);
+            continue;
+        }
+        // relative error beyond the rounding of the result
+        max_err_mag = fmax(max_err_mag, (fabs(mag[i] - ref_mag) - 0.5)
+                                        / ref_mag);
+        max_err_phase = fmax(max_err_phase, fabs(ldexp(phase[i], -28)
+                                                 - ref_phase));
+        mismatch += (mag[i] != fix32_cmplx_mag(b[i]))
+                  + (phase[i] != fix32_cmplx_phase(b[i]));
+    }
+    check("cmplx magnitude", max_err_mag, 1e-4);
+    check("cmplx phase", max_err_phase, 0.0051);
+    check("cmplx magnitude/phase arrays", mismatch, 0.);
+}
+
+
+/**
+ * FM discriminator on a stream of random samples of any magnitude (including
+ * repeated samples of INT32_MIN, whose conjugate product is 2^63) against
+ * the phase difference computed with 'atan2()', in blocks of odd sizes
+ */
+static void check_cmplx_disc(void)
+{
+    enum { N = 1000, BLOCK = 37 };
+    const double pi = 3.14159265358979323846;
+    static fix32_cmplx in[N];
+    static int32_t out[N];
+    fix32_cmplx_disc disc;
+    double max_err = 0.;
+    size_t i, pos;
+    for (i = 0; i < N; i++) {
+        int bits = i % 32;
+        in[i].re = (bits == 31) ? INT32_MIN : check_rand(bits);
+        in[i].im = (bits == 31) ? INT32_MIN : check_rand(bits);
+    }
+    in[32] = in[31];
+
+    fix32_cmplx_disc_init(&disc);
+    for (pos = 0; pos < N; pos += BLOCK)
+        fix32_cmplx_disc_process(&disc, in + pos, out + pos,
+                                 (N - pos < BLOCK) ? N - pos : BLOCK);
+
+    // the predecessor of the first sample is 0
+    for (i = 0; i < N; i++) {
+        double re = i ? in[i - 1].re : 0., im = i ? in[i - 1].im : 0.;
+        // adding 0 turns a real part of -0 into 0, whose phase is 0
+        double ref = atan2(in[i].im * re - in[i].re * im,
+                           in[i].re * re + in[i].im * im + 0.);
+        double err = fabs(ldexp(out[i], -28) - ref);
+        // -pi and pi are the same phase
+        max_err = fmax(max_err, fmin(err, fabs(err - 2. * pi)));
+    }
+    check("cmplx discriminator", max_err, 0.0051);
+}
+
+
+/**
+ * Sine and cosine of phases in turns within the documented 2^-21 for the
+ * default sine table (the interpolation error scales with the square of the
+ * table step), the NCO across blocks against 'fix32_sincos_turn()',
+ * conversions between radians and turns, and unwrapping of a random walk of
+ * the phase, which must be restored exactly
+ */
+static void check_nco(void)
+{
+    enum { N = 1000, BLOCK = 37 };
+    const double pi = 3.14159265358979323846;
+    const int64_t two_pi = (int64_t)(2. * pi * (1 << 28) + 0.5);
+    const double tol = ldexp(1., 2 * (12 - FIX32_SINTAB_BITS) - 21)
+                       + ldexp(1., -29);
+    static fix32_cmplx out[N];
+    static int32_t wrapped[N];
+    static int64_t phase[N], unwrapped[N];
+    fix32_nco nco;
+    fix32_unwrap unwrap;
+    double max_err = 0., max_err_rad = 0., max_err_turn = 0.,
+           mismatch = 0.;
+    uint32_t turn, freq = 0x12345679u, phase0 = 0xFEDCBA98u;
+    int32_t sin_val, cos_val, rad;
+    size_t i, pos;
+
+    // every table entry at a quarter and half of its step
+    for (i = 0; i < (1u << 20); i++) {
+        turn = (uint32_t)i << 12 | 0x400;
+        fix32_sincos_turn(turn, &sin_val, &cos_val);
+        double arg = ldexp(2. * pi * turn, -32);
+        max_err = fmax(max_err, fabs(ldexp(sin_val, -30) - sin(arg)));
+        max_err = fmax(max_err, fabs(ldexp(cos_val, -30) - cos(arg)));
+    }
+    check("sincos turn", max_err, tol);
+
+    fix32_nco_init(&nco, freq, phase0);
+    for (pos = 0; pos < N; pos += BLOCK)
+        fix32_nco_process(&nco, out + pos, (N - pos < BLOCK) ? N - pos
+                                                               : BLOCK);
+    for (i = 0; i < N; i++) {
+        fix32_sincos_turn(phase0 + (uint32_t)i * freq, &sin_val, &cos_val);
+        mismatch += (out[i].re != cos_val) + (out[i].im != sin_val);
+    }
+    mismatch += nco.phase != phase0 + (uint32_t)N * freq;
+
+    // phases in radians (scaling factor 2^28) in (-pi, pi)
+    for (i = 0; i < N; i++) {
+        rad = (int32_t)(check_rand(31) % (two_pi / 2));
+        turn = fix32_rad_to_turn(rad);
+        // modulo a full turn
+        max_err_turn = fmax(max_err_turn,
+                            fabs(remainder(turn - ldexp(rad, 3) / pi,
+                                           ldexp(1., 32))));
+        max_err_rad = fmax(max_err_rad,
+                           fabs((double)fix32_turn_to_rad(turn) - rad));
+    }
+    check("rad to turn", max_err_turn, 1.);
+    check("rad to turn round trip", max_err_rad, 1.);
+
+    // random walk with steps below pi, wrapped to [-pi, pi)
+    for (i = 0; i < N; i++) {
+        phase[i] = (i ? phase[i - 1] : 0) + check_rand(29);
+        wrapped[i] = (int32_t)(phase[i] - two_pi
+                               * (int64_t)floor((double)phase[i] / two_pi
+                                                + 0.5));
+    }
+    fix32_unwrap_init(&unwrap);
+    for (pos = 0; pos < N; pos += BLOCK)
+        fix32_unwrap_process(&unwrap, wrapped + pos, unwrapped + pos,
+                             (N - pos < BLOCK) ? N - pos : BLOCK);
+    for (i = 0; i < N; i++)
+        mismatch += unwrapped[i] != phase[i];
+    check("nco and unwrap", mismatch, 0.);
+}
+
+
+/**
+ * Clamp a 64-bit value to 32 bits (reference for the saturating functions)
+ */
+static int32_t check_clamp(int64_t val)
+{
+    return (int32_t)(val < INT32_MIN ? INT32_MIN
+                     : val > INT32_MAX ? INT32_MAX : val);
+}
+
+/**
+ * Saturating addition, subtraction, multiplication and multiply-accumulate
+ * of edge values and random operands of any magnitude against a clamped
+ * 64-bit reference (the products rounded like 'fix32_mul()'); the array
+ * variants must match the scalar functions
+ */
+static void check_sat(void)
+{
+    enum { EDGES = 7, N = EDGES * EDGES + 1000 };
+    static const int32_t edges[EDGES] = {
+        INT32_MIN, INT32_MIN + 1, -1, 0, 1, INT32_MAX - 1, INT32_MAX
+    };
+    static int32_t a[N], b[N], c[N], sum[N], diff[N], prod[N];
+    double mismatch = 0.;
+    int i, n;
+    for (i = 0; i < N; i++) {
+        a[i] = (i < EDGES * EDGES) ? edges[i / EDGES] : check_rand(i % 32);
+        b[i] = (i < EDGES * EDGES) ? edges[i % EDGES] : check_rand(i % 31);
+        c[i] = check_rand(31);
+    }
+
+    fix32_add_sat_array(a, b, sum, N);
+    fix32_sub_sat_array(a, b, diff, N);
+    for (i = 0; i < N; i++) {
+        int32_t ref_sum = check_clamp((int64_t)a[i] + b[i]),
+                ref_diff = check_clamp((int64_t)a[i] - b[i]);
+        mismatch += (fix32_add_sat(a[i], b[i]) != ref_sum)
+                  + (fix32_sub_sat(a[i], b[i]) != ref_diff)
+                  + (sum[i] != ref_sum) + (diff[i] != ref_diff);
+    }
+
+    for (n = 1; n < 32; n++) {
+        fix32_mul_sat_array(a, b, prod, N, n);
+        for (i = 0; i < N; i++) {
+            int64_t p = check_round_64((int64_t)a[i] * b[i], n, FIX32_RHAZ);
+            mismatch += (fix32_mul_sat(a[i], b[i], n) != check_clamp(p))
+                      + (prod[i] != check_clamp(p))
+                      + (fix32_mac_sat(c[i], a[i], b[i], n)
+                         != check_clamp(c[i] + p));
+        }
+    }
+    check("saturating arithmetic", mismatch, 0.);
+}
+
+
+/**
+ * Multiplication with explicitly named rounding flavour, with and without
+ * saturation, against the reference rounding; the operands of few bits
+ * produce many ties, which tell the flavours apart
+ */
+static void check_rounding(void)
+{
+    enum { N = 1000 };
+    double mismatch = 0.;
+    int i, n;
+    for (n = 1; n < 32; n++) {
+        for (i = 0; i < N; i++) {
+            int32_t a = check_rand(i % 32), b = check_rand(i % 8);
+            int64_t prod = (int64_t)a * b;
+            int64_t rhu = check_round_64(prod, n, FIX32_RHU),
+                    rhd = check_round_64(prod, n, FIX32_RHD),
+                    rhaz = check_round_64(prod, n, FIX32_RHAZ),
+                    rhtz = check_round_64(prod, n, FIX32_RHTZ);
+            mismatch += (fix32_mul_rhu(a, b, n) != (int32_t)rhu)
+                      + (fix32_mul_rhd(a, b, n) != (int32_t)rhd)
+                      + (fix32_mul_rhaz(a, b, n) != (int32_t)rhaz)
+                      + (fix32_mul_rhtz(a, b, n) != (int32_t)rhtz)
+                      + (fix32_acc_scale_rhu(prod, n) != (int32_t)rhu)
+                      + (fix32_acc_scale_rhd(prod, n) != (int32_t)rhd)
+                      + (fix32_acc_scale_rhaz(prod, n) != (int32_t)rhaz)
+                      + (fix32_acc_scale_rhtz(prod, n) != (int32_t)rhtz)
+                      + (fix32_mul_rhu_sat(a, b, n) != check_clamp(rhu))
+                      + (fix32_mul_rhd_sat(a, b, n) != check_clamp(rhd))
+                      + (fix32_mul_rhaz_sat(a, b, n) != check_clamp(rhaz))
+                      + (fix32_mul_rhtz_sat(a, b, n) != check_clamp(rhtz))
+                      + (fix32_acc_scale_rhu_sat(prod, n) != check_clamp(rhu))
+                      + (fix32_acc_scale_rhd_sat(prod, n) != check_clamp(rhd))
+                      + (fix32_acc_scale_rhaz_sat(prod, n)
+                         != check_clamp(rhaz))
+                      + (fix32_acc_scale_rhtz_sat(prod, n)
+                         != check_clamp(rhtz));
+        }
+    }
+    check("rounding flavours", mismatch, 0.);
+}
+
+
+/**
+ * atan2 of random values of any magnitude within the documented 0.0051,
+ * with the same result for every value of the deprecated 'scale' argument
+ */
+static void check_atan2(void)
+{
+    enum { N = 1000 };
+    double max_err = 0., mismatch = 0.;
+    int i, scale;
+    mismatch += fix32_atan2(0, 0, 0) != 0;
+    for (i = 0; i < N; i++) {
+        int32_t y = check_rand(i % 32), x = check_rand(i % 31);
+        int32_t res = fix32_atan2(y, x, 0);
+        if (x == 0 && y == 0)
+            continue;
+        max_err = fmax(max_err, fabs(ldexp(res, -28) - atan2(y, x)));
+        for (scale = 1; scale < 32; scale++)
+            mismatch += fix32_atan2(y, x, scale) != res;
+    }
+    check("atan2", max_err, 0.0051);
+    check("atan2 independent of scale", mismatch, 0.);
+}
+
+
+/**
+ * Pseudo-random 64-bit value in [-2^bits, 2^bits)
+ */
+static int64_t check_rand_64(int bits)
+{
+    uint64_t val = (uint64_t)(uint32_t)check_rand(31) << 32
+                 | (uint32_t)check_rand(31);
+    return (int64_t)val >> (63 - bits);
+}
+
+/**
+ * Inverse square root, square root and atan2 of 64-bit values of any
+ * magnitude against long double references; the documented errors are in the
+ * order of 2^-60 (relative) and 2^-56 (absolute), which the tolerances allow
+ * twice, or in the order of the precision of long double if that is lower
+ */
+static void check_fix64(void)
+{
+    enum { N = 1000 };
+    const long double eps = 4 * LDBL_EPSILON;
+    double max_err_invsqrt = 0., max_err_sqrt = 0., max_err_atan2 = 0.;
+    int i;
+    for (i = 0; i < N; i++) {
+        uint64_t val = (uint64_t)check_rand_64(i % 63 + 1) >> 1 | 1;
+        int scale_in = i % 64, scale;
+        long double x = ldexpl((long double)val, -scale_in);
+
+        scale = scale_in;
+        uint64_t inv = fix64_invsqrt(val, &scale);
+        max_err_invsqrt = fmax(max_err_invsqrt, (double)fabsl(
+            ldexpl((long double)inv, -scale) * sqrtl(x) - 1));
+
+        scale = scale_in;
+        uint64_t root = fix64_sqrt(val, &scale);
+        max_err_sqrt = fmax(max_err_sqrt, (double)fabsl(
+            ldexpl((long double)root, -scale) / sqrtl(x) - 1));
+
+        int64_t y = check_rand_64(i % 64), z = check_rand_64((i * 7) % 64);
+        if (y == 0 && z == 0)
+            continue;
+        max_err_atan2 = fmax(max_err_atan2, (double)fabsl(
+            ldexpl((long double)fix64_atan2(y, z, 0), -60)
+            - atan2l((long double)y, (long double)z)));
+    }
+    check("fix64 invsqrt", max_err_invsqrt, fmax(ldexp(1., -59), eps));
+    check("fix64 sqrt", max_err_sqrt, fmax(ldexp(1., -59), eps));
+    check("fix64 atan2", max_err_atan2, fmax(ldexp(1., -55), eps));
+    check("fix64 atan2 of 0", fix64_atan2(0, 0, 0) != 0, 0.);
+}
+
+
+/**
+ * Q15 kernels: multiplication and dot product against an exact reference
+ * (rounded half up), the inverse square root of every positive 16-bit value
+ * within the documented relative error of about 2^-13 (also with a common
+ * output scale, beyond the rounding of the result) and atan2 on a grid
+ * covering all magnitudes within the documented absolute error of about
+ * 2^-13; the array variants must match the scalar functions
+ */
+static void check_fix15(void)
+{
+    enum { N = 1000, STEP = 97 };
+    static int16_t a[N], b[N], prod[N], src[INT16_MAX], dst[INT16_MAX];
+    static int16_t y[(65536 / STEP + 1) * (65536 / STEP + 1)],
+                   x[sizeof(y) / sizeof(y[0])], res[sizeof(y) / sizeof(y[0])];
+    double mismatch = 0., max_err_inv = 0., max_err_arr = 0.,
+           max_err_atan2 = 0.;
+    int64_t acc = 0;
+    int i, j, count, scale;
+    for (i = 0; i < N; i++) {
+        a[i] = (int16_t)check_rand(15);
+        b[i] = (int16_t)check_rand(i % 16);
+    }
+    a[0] = b[0] = INT16_MIN;
+
+    fix15_mul_array(a, b, prod, N);
+    for (i = 0; i < N; i++) {
+        int16_t ref = (int16_t)(((int32_t)a[i] * b[i] + (1 << 14)) >> 15);
+        mismatch += (fix15_mul(a[i], b[i]) != ref) + (prod[i] != ref);
+        acc += (int32_t)a[i] * b[i];
+    }
+    mismatch += fix15_dot(a, b, N, 15) != (int32_t)((acc + (1 << 14)) >> 15);
+    check("fix15 mul and dot", mismatch, 0.);
+
+    for (i = 0; i < INT16_MAX; i++)
+        src[i] = (int16_t)(i + 1);
+    for (scale = 0; scale <= 15; scale += 5) {
+        int res_scale = 12;
+        fix15_invsqrt_array(src, dst, INT16_MAX, scale, res_scale);
+        for (i = 0; i < INT16_MAX; i++) {
+            int inv_scale = scale;
+            int16_t inv = fix15_invsqrt(src[i], &inv_scale);
+            double ref = 1. / sqrt(ldexp(src[i], -scale));
+            max_err_inv = fmax(max_err_inv,
+                               fabs(ldexp(inv, -inv_scale) / ref - 1.));
+            // the common output scale saturates large results
+            double ref_arr = fmin(ldexp(ref, res_scale), INT16_MAX);
+            max_err_arr = fmax(max_err_arr, (fabs(dst[i] - ref_arr) - 0.5)
+                                            / ref_arr);
+        }
+    }
+    check("fix15 invsqrt", max_err_inv, ldexp(1., -12));
+    check("fix15 invsqrt array", max_err_arr, ldexp(1., -12));
+
+    count = 0;
+    for (i = INT16_MIN; i <= INT16_MAX; i += STEP) {
+        for (j = INT16_MIN; j <= INT16_MAX; j += STEP) {
+            y[count] = (int16_t)i;
+            x[count] = (int16_t)j;
+            count++;
+        }
+    }
+    fix15_atan2_array(y, x, res, count);
+    for (i = 0; i < count; i++) {
+        double ref = (x[i] == 0 && y[i] == 0) ? 0. : atan2(y[i], x[i]);
+        max_err_atan2 = fmax(max_err_atan2, fabs(ldexp(res[i], -13) - ref));
+        mismatch += fix15_atan2(y[i], x[i]) != res[i];
+    }
+    mismatch += fix15_atan2(0, 0) != 0;
+    check("fix15 atan2", max_err_atan2, ldexp(1., -12));
+    check("fix15 arrays", mismatch, 0.);
+}
+
+
+/**
+ * Largest error of the elements of a block against reference values beyond a
+ * relative error 'rel', in units of 2^-unit_scale, or 2^31 if the block is
+ * not normalized (largest magnitude between 2^29 and 2^30) although the
+ * reference is not all zeros
+ */
+static double check_bfp_err(const fix32_bfp *bfp, const double *ref,
+                            int unit_scale, double rel)
+{
+    double max_err = 0., max_ref = 0.;
+    int32_t max_mant = 0;
+    size_t i;
+    for (i = 0; i < bfp->count; i++) {
+        int32_t mag = (bfp->mant[i] < 0) ? -bfp->mant[i] : bfp->mant[i];
+        max_mant = (mag > max_mant) ? mag : max_mant;
+        max_ref = fmax(max_ref, fabs(ref[i]));
+        max_err = fmax(max_err, fabs(ldexp(bfp->mant[i], -bfp->scale)
+                                     - ref[i]) - rel * fabs(ref[i]));
+    }
+    if (max_ref > 0. && (max_mant < (1 << 29) || max_mant > (1 << 30)))
+        return ldexp(1., 31);
+    return ldexp(max_err, unit_scale);
+}
+
+/**
+ * Block floating point arithmetic on blocks of random mantissas of any
+ * magnitude and scale against double precision: the results must be
+ * normalized, the products within 1 LSB, the sums within 1 LSB of the common
+ * scale of the operands (cancellation may amplify it in the normalized
+ * result) and the square roots within 1 LSB beyond the relative error of
+ * 'fix32_invsqrt()'
+ */
+static void check_bfp(void)
+{
+    enum { N = 64, BLOCKS = 100 };
+    static int32_t mant_a[N], mant_b[N], mant_res[N];
+    static double val_a[N], val_b[N], ref[N];
+    fix32_bfp a, b, res;
+    double max_err = 0., max_err_sqrt = 0., mismatch = 0.;
+    int k, i, headroom;
+    for (k = 0; k < BLOCKS; k++) {
+        int bits_a = k % 31, bits_b = (k * 7) % 31;
+        for (i = 0; i < N; i++) {
+            mant_a[i] = check_rand(bits_a);
+            mant_b[i] = check_rand(bits_b);
+        }
+        fix32_bfp_init(&a, mant_a, N, k % 40 - 20);
+        fix32_bfp_init(&b, mant_b, N, (k * 3) % 40 - 20);
+        fix32_bfp_init(&res, mant_res, N, 0);
+
+        // the headroom is that of the largest magnitude
+        for (headroom = 31; headroom > 0; headroom--) {
+            for (i = 0; i < N; i++) {
+                int32_t m = mant_a[i];
+                if (((m < 0) ? ~m : m) >> (31 - headroom))
+                    break;
+            }
+            if (i == N)
+                break;
+        }
+        mismatch += fix32_bfp_headroom(&a) != headroom;
+
+        // normalization shifts left without rounding (the mantissas have at
+        // most 31 significant bits)
+        for (i = 0; i < N; i++)
+            ref[i] = ldexp(mant_a[i], -a.scale);
+        fix32_bfp_normalize(&a);
+        fix32_bfp_normalize(&b);
+        max_err = fmax(max_err, check_bfp_err(&a, ref, a.scale, 0.));
+        for (i = 0; i < N; i++) {
+            val_a[i] = ldexp(mant_a[i], -a.scale);
+            val_b[i] = ldexp(mant_b[i], -b.scale);
+        }
+
+        for (i = 0; i < N; i++)
+            ref[i] = val_a[i] * val_b[i];
+        fix32_bfp_mul(&a, &b, &res);
+        max_err = fmax(max_err, check_bfp_err(&res, ref, res.scale, 0.));
+
+        for (i = 0; i < N; i++)
+            ref[i] = val_a[i] + val_b[i];
+        fix32_bfp_add(&a, &b, &res);
+        max_err = fmax(max_err, check_bfp_err(&res, ref, (a.scale < b.scale)
+                                              ? a.scale - 1 : b.scale - 1,
+                                              0.));
+
+        // positive elements
+        for (i = 0; i < N; i++) {
+            mant_a[i] = (mant_a[i] < 0) ? -mant_a[i] : mant_a[i] + 1;
+            val_a[i] = ldexp(mant_a[i], -a.scale);
+            ref[i] = sqrt(val_a[i]);
+        }
+        fix32_bfp_sqrt(&a, &res);
+        max_err_sqrt = fmax(max_err_sqrt,
+                            check_bfp_err(&res, ref, res.scale, 1e-4));
+        for (i = 0; i < N; i++)
+            ref[i] = 1. / sqrt(val_a[i]);
+        fix32_bfp_invsqrt(&a, &res);
+        max_err_sqrt = fmax(max_err_sqrt,
+                            check_bfp_err(&res, ref, res.scale, 1e-4));
+    }
+    check("bfp headroom", mismatch, 0.);
+    check("bfp arithmetic", max_err, 1.);
+    check("bfp square roots", max_err_sqrt, 1.);
+}
+
+
+/**
+ * Inverse square root of arrays of values of any magnitude with a common
+ * output scale: within 1 LSB beyond the relative error of 'fix32_invsqrt()',
+ * with saturation of results (and elements equal to 0) which exceed 32 bits;
+ * the '_auto' variant must choose the scale which puts the largest result
+ * between 2^29 and 2^30
+ */
+static void check_invsqrt_array(void)
+{
+    enum { N = 1000 };
+    static uint32_t src[N];
+    static int32_t dst[N];
+    double max_err = 0., mismatch = 0.;
+    int i, k, scale = 20;
+    for (k = 0; k < 2; k++) {
+        // the second pass has no 0 elements and a limited range of magnitudes
+        for (i = 0; i < N; i++)
+            src[i] = k ? (uint32_t)check_rand(31) >> (i % 16) | 1
+                       : (uint32_t)check_rand(31) >> (i % 32);
+
+        int res_scale = k ? fix32_invsqrt_array_auto(src, dst, N, scale) : 25;
+        if (!k)
+            fix32_invsqrt_array(src, dst, N, scale, res_scale);
+
+        int32_t max = 0;
+        for (i = 0; i < N; i++) {
+            double ref = (src[i] == 0) ? INFINITY
+                       : ldexp(1. / sqrt(ldexp(src[i], -scale)), res_scale);
+            if (ref > INT32_MAX) {
+                mismatch += dst[i] != INT32_MAX;
+                continue;
+            }
+            max_err = fmax(max_err, fabs(dst[i] - ref) - 1e-4 * ref);
+            max = (dst[i] > max) ? dst[i] : max;
+        }
+        if (k)
+            mismatch += (max < (1 << 29)) || (max > (1 << 30));
+    }
+    check("invsqrt array", max_err, 1.);
+    check("invsqrt array scale", mismatch, 0.);
+}
+
+
+/**
+ * Reference conversion of a double to a fixed point number with a scaling
+ * factor of 2^scale: round the exact value with one of the flavours of
+ * 'fix32_rounding' and saturate; NaN yields 0
+ */
+static int32_t check_from_double(double val, int scale,
+                                 fix32_rounding rounding)
+{
+    double x = ldexp(val, scale), q = floor(x);
+    if (x != x)
+        return 0;
+    if (x - q > 0.5 || (x - q == 0.5
+                        && (rounding == FIX32_RHU
+                            || (rounding == FIX32_RHAZ && x > 0.)
+                            || (rounding == FIX32_RHTZ && x < 0.))))
+        q += 1.;
+    return (q < INT32_MIN) ? INT32_MIN : (q > INT32_MAX) ? INT32_MAX
+                                                         : (int32_t)q;
+}
+
+/**
+ * Conversion of float and double arrays (including ties, values out of
+ * range, infinities and NaN) to fixed point with all rounding flavours
+ * against the reference, and back, which must be exact for double and
+ * correctly rounded for float
+ */
+static void check_conv(void)
+{
+    enum { SPECIAL = 8, N = SPECIAL + 1000 };
+    static const double special[SPECIAL] = {
+        0.5, -0.5, 1.5, -2.5, 2147483647.5, -2147483648.5, 1e300, -1e300
+    };
+    static double dbl[N], res_dbl[N];
+    static float flt[N], res_flt[N];
+    static int32_t fix_dbl[N], fix_flt[N];
+    double mismatch = 0.;
+    int i, scale, rounding;
+    for (i = 0; i < N; i++) {
+        // ties and random values of any magnitude
+        dbl[i] = (i < SPECIAL) ? special[i]
+               : ldexp(check_rand(31), -(i % 64)) + ((i & 1) ? 0.5 : 0.);
+        flt[i] = (float)dbl[i];
+    }
+    dbl[N - 1] = flt[N - 1] = INFINITY;
+    dbl[N - 2] = flt[N - 2] = -INFINITY;
+    dbl[N - 3] = flt[N - 3] = NAN;
+
+    for (scale = -8; scale <= 40; scale += 8) {
+        for (rounding = FIX32_RHU; rounding <= FIX32_RHTZ; rounding++) {
+            fix32_from_double(dbl, fix_dbl, N, scale,
+                              (fix32_rounding)rounding);
+            fix32_from_float(flt, fix_flt, N, scale,
+                             (fix32_rounding)rounding);
+            for (i = 0; i < N; i++)
+                mismatch += (fix_dbl[i] != check_from_double(
+                                 dbl[i], scale, (fix32_rounding)rounding))
+                          + (fix_flt[i] != check_from_double(
+                                 flt[i], scale, (fix32_rounding)rounding));
+        }
+
+        fix32_to_double(fix_dbl, res_dbl, N, scale);
+        fix32_to_float(fix_dbl, res_flt, N, scale);
+        for (i = 0; i < N; i++)
+            mismatch += (res_dbl[i] != ldexp(fix_dbl[i], -scale))
+                      + (res_flt[i] != (float)ldexp(fix_dbl[i], -scale));
+    }
+    check("float/double conversion", mismatch, 0.);
+}
+
+
+/**
+ * Decimal formatting of random values of any magnitude against printf() of
+ * the exact value, and parsing of the exact decimal representation with the
+ * same or a lower scale (which yields ties) against the reference rounding;
+ * the array variants must round-trip
+ */
+static void check_str(void)
+{
+    enum { N = 1000 };
+    static int32_t src[N], dst[N];
+    static char buf[N * (FIX32_STR_LEN(32) + 1)];
+    char str[FIX32_STR_LEN(32) + 1], ref[64];
+    const char *end;
+    double mismatch = 0.;
+    int i, scale, rounding;
+    unsigned digits;
+    for (i = 0; i < N; i++)
+        src[i] = check_rand(i % 32);
+    src[0] = INT32_MIN;
+    src[1] = INT32_MAX;
+
+    for (scale = 0; scale <= 32; scale += 4) {
+        for (i = 0; i < N; i++) {
+            for (digits = 0; digits <= 12; digits += 3) {
+                size_t len = fix32_to_str(src[i], str, scale, digits);
+                snprintf(ref, sizeof(ref), "%.*f", (int)digits,
+                         ldexp(src[i], -scale));
+                mismatch += (strcmp(str, ref) != 0) + (len != strlen(ref));
+            }
+
+            // exact with as many digits as the scale
+            fix32_to_str(src[i], str, scale, (unsigned)scale);
+            for (rounding = FIX32_RHU; rounding <= FIX32_RHTZ; rounding++) {
+                int k = (scale < 3) ? scale : 3;
+                int32_t val = fix32_from_str(str, &end, scale - k,
+                                             (fix32_rounding)rounding);
+                int64_t exp = k ? check_round_64(src[i], k,
+                                                 (fix32_rounding)rounding)
+                                : src[i];
+                mismatch += (val != (int32_t)exp) || (*end != '\0');
+            }
+        }
+
+        fix32_to_str_array(src, buf, N, scale, (unsigned)scale, ',');
+        mismatch += fix32_from_str_array(buf, dst, N, scale, FIX32_RHAZ,
+                                         &end) != N;
+        mismatch += *end != '\0';
+        for (i = 0; i < N; i++)
+            mismatch += dst[i] != src[i];
+    }
+    check("decimal strings", mismatch, 0.);
+}
+
+
+/**
+ * Kernel of 'check_par()' counting how often each element is processed
+ */
+static void check_par_count(size_t beg, size_t end, void *ctx)
+{
+    int32_t *visits = ctx;
+    size_t i;
+    for (i = beg; i < end; i++)
+        visits[i]++;
+}
+
+/**
+ * Thread pool with a count which is not a multiple of the number of threads:
+ * every element must be processed exactly once for any chunk size, and the
+ * parallel kernels must match the sequential ones bit by bit, also after the
+ * pool has been stopped
+ */
+static void check_par(void)
+{
+    enum { N = 100003 };
+    static uint32_t src[N];
+    static int32_t visits[N], dst[N], ref[N];
+    static fix32_cmplx a[N];
+    static float flt[N], flt_ref[N];
+    static double dbl[N], dbl_ref[N];
+    double mismatch = 0.;
+    size_t i, chunk;
+    int pass;
+    for (i = 0; i < N; i++) {
+        src[i] = (uint32_t)check_rand(31) >> (i % 32) | 1;
+        a[i].re = check_rand(i % 31);
+        a[i].im = check_rand(i % 29);
+    }
+
+    mismatch += fix32_par_init(3) != 3;
+    for (pass = 0; pass < 2; pass++) {
+        for (chunk = 0; chunk <= 1000; chunk += 333) {
+            fix32_par_touch(visits, N, sizeof(visits[0]));
+            fix32_par_for(N, chunk, check_par_count, visits);
+            for (i = 0; i < N; i++)
+                mismatch += visits[i] != 1;
+        }
+
+        fix32_invsqrt_array(src, ref, N, 20, 25);
+        fix32_par_invsqrt_array(src, dst, N, 20, 25);
+        for (i = 0; i < N; i++)
+            mismatch += dst[i] != ref[i];
+
+        fix32_cmplx_phase_array(a, ref, N);
+        fix32_par_cmplx_phase_array(a, dst, N);
+        for (i = 0; i < N; i++)
+            mismatch += dst[i] != ref[i];
+
+        fix32_to_float(ref, flt_ref, N, 28);
+        fix32_par_to_float(ref, flt, N, 28);
+        fix32_to_double(ref, dbl_ref, N, 28);
+        fix32_par_to_double(ref, dbl, N, 28);
+        for (i = 0; i < N; i++)
+            mismatch += (flt[i] != flt_ref[i]) + (dbl[i] != dbl_ref[i]);
+
+        fix32_from_float(flt, ref, N, 20, FIX32_RHD);
+        fix32_par_from_float(flt, dst, N, 20, FIX32_RHD);
+        for (i = 0; i < N; i++)
+            mismatch += dst[i] != ref[i];
+        fix32_from_double(dbl, ref, N, 20, FIX32_RHTZ);
+        fix32_par_from_double(dbl, dst, N, 20, FIX32_RHTZ);
+        for (i = 0; i < N; i++)
+            mismatch += dst[i] != ref[i];
+
+        // the second pass runs in the calling thread
+        if (pass == 0)
+            fix32_par_shutdown();
+    }
+    check("thread pool", mismatch, 0.);
+}
+
+
+/**
+ * Batch kernels on values of any magnitude (and odd scales, which the inverse
+ * square root handles specially) against the scalar functions, which they
+ * must match bit by bit
+ */
+static void check_batch(void)
+{
+    enum { N = 1003 };
+    static int32_t a[N], b[N], res[N], res_scale[N];
+    static uint32_t src[N];
+    double mismatch = 0.;
+    int i, n, scale;
+    for (i = 0; i < N; i++) {
+        a[i] = check_rand(i % 32);
+        b[i] = check_rand((i * 7) % 32);
+        src[i] = (uint32_t)check_rand(31) >> (i % 32) | 1;
+    }
+    a[0] = b[0] = 0;
+
+    for (n = 1; n < 32; n += 3) {
+        fix32_batch_mul(a, b, res, N, n);
+        for (i = 0; i < N; i++)
+            mismatch += res[i] != fix32_mul(a[i], b[i], n);
+    }
+
+    for (scale = 0; scale < 32; scale += 5) {
+        fix32_batch_invsqrt(src, res, res_scale, N, scale);
+        for (i = 0; i < N; i++) {
+            int ref_scale = scale;
+            int32_t ref = (int32_t)fix32_invsqrt(src[i], &ref_scale);
+            mismatch += (res[i] != ref) + (res_scale[i] != ref_scale);
+        }
+    }
+
+    fix32_batch_atan2(a, b, res, N);
+    for (i = 0; i < N; i++)
+        mismatch += res[i] != fix32_atan2(a[i], b[i], 0);
+    check("batch kernels vs scalar", mismatch, 0.);
+}
+
+
+// C++ part of the checks (tools/fix32check_cpp.cpp)
+double fix32check_cpp_policies(const int32_t *a, const int32_t *b,
+                               size_t count);
+double fix32check_cpp_fixed(const int32_t *a, const int32_t *b,
+                            size_t count);
+double fix32check_cpp_constexpr(void);
+
+/**
+ * C++ interfaces with random operands of any magnitude (including edge
+ * values) against the C functions
+ */
+static void check_cpp(void)
+{
+    enum { N = 1000 };
+    static int32_t a[N], b[N];
+    int i;
+    for (i = 0; i < N; i++) {
+        a[i] = check_rand(i % 32);
+        b[i] = check_rand((i * 7) % 32);
+    }
+    a[0] = b[0] = a[1] = INT32_MIN;
+    b[1] = a[2] = INT32_MAX;
+    b[2] = -1;
+
+    check("C++ rounding and overflow policies",
+          fix32check_cpp_policies(a, b, N), 0.);
+    check("C++ fixed point type", fix32check_cpp_fixed(a, b, N), 0.);
+    check("C++ constexpr functions", fix32check_cpp_constexpr(), 0.);
+}
+
+
+int main(void)
+{
+    check_fft_full_scale();
+    check_fft();
+    check_quat_rotate_limit();
+    check_mat_inverse_underflow();
+    check_fir_zero_taps();
+    check_fir();
+    check_biquad();
+    check_vec_normalize();
+    check_quat();
+    check_mat3();
+#ifdef __SIZEOF_INT128__
+    check_dot();
+#endif
+    check_cmplx();
+    check_cmplx_disc();
+    check_nco();
+    check_sat();
+    check_rounding();
+    check_atan2();
+    check_fix64();
+    check_fix15();
+    check_bfp();
+    check_invsqrt_array();
+    check_conv();
+    check_str();
+    check_par();
+    check_batch();
+    check_cpp();
+
+    if (failures == 0)
+        printf("all checks passed\n");
+    return failures != 0;
+}
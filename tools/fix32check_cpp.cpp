@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+
+/**
+ * C++ part of the regression checks for libfix32math ('make check'): the
+ * per-call-site policies, 'fix32::fixed<>' and the constexpr variants are
+ * compared with the C functions by 'tools/fix32check.c', which provides the
+ * operands.  Each function returns the number of mismatches.
+ */
+
+#include <stddef.h>
+
+#include "fix32constexpr.hpp"
+#include "fix32fixed.hpp"
+
+extern "C" {
+double fix32check_cpp_policies(const int32_t *a, const int32_t *b,
+                               size_t count);
+double fix32check_cpp_fixed(const int32_t *a, const int32_t *b,
+                            size_t count);
+double fix32check_cpp_constexpr(void);
+}
+
+
+// results passed to the overflow handler of 'overflow::check'
+static size_t overflow_calls = 0;
+
+int32_t fix32::overflow_handler(int64_t val)
+{
+    overflow_calls++;
+    return fix32_sat_64(val);
+}
+
+
+/**
+ * Rounding and overflow policies of one rounding flavour against the C
+ * functions with explicitly named rounding; the check policy must call the
+ * handler exactly for the results which saturate.
+ */
+template <fix32_rounding R>
+static double check_policies(const int32_t *a, const int32_t *b,
+                             size_t count, int32_t (*mul_c)(int32_t, int32_t,
+                                                             int),
+                             int32_t (*mul_sat_c)(int32_t, int32_t, int))
+{
+    using fix32::overflow;
+    double mismatch = 0.;
+    size_t i, overflows = 0;
+    int n;
+    overflow_calls = 0;
+    for (n = 1; n < 32; n += 5) {
+        for (i = 0; i < count; i++) {
+            int32_t wrap = fix32::mul<R, overflow::wrap>(a[i], b[i], n),
+                    sat = fix32::mul<R, overflow::saturate>(a[i], b[i], n),
+                    chk = fix32::mul<R, overflow::check>(a[i], b[i], n);
+            overflows += sat != mul_c(a[i], b[i], n);
+            mismatch += (wrap != mul_c(a[i], b[i], n))
+                      + (sat != mul_sat_c(a[i], b[i], n)) + (chk != sat);
+        }
+    }
+    return mismatch + (overflow_calls != overflows);
+}
+
+double fix32check_cpp_policies(const int32_t *a, const int32_t *b,
+                               size_t count)
+{
+    using fix32::overflow;
+    double mismatch = 0.;
+    size_t i, overflows = 0;
+    mismatch += check_policies<FIX32_RHU>(a, b, count, fix32_mul_rhu,
+                                          fix32_mul_rhu_sat);
+    mismatch += check_policies<FIX32_RHD>(a, b, count, fix32_mul_rhd,
+                                          fix32_mul_rhd_sat);
+    mismatch += check_policies<FIX32_RHAZ>(a, b, count, fix32_mul_rhaz,
+                                           fix32_mul_rhaz_sat);
+    mismatch += check_policies<FIX32_RHTZ>(a, b, count, fix32_mul_rhtz,
+                                           fix32_mul_rhtz_sat);
+
+    overflow_calls = 0;
+    for (i = 0; i < count; i++) {
+        int32_t sum = fix32_add_sat(a[i], b[i]),
+                diff = fix32_sub_sat(a[i], b[i]);
+        overflows += (sum != (int32_t)((uint32_t)a[i] + (uint32_t)b[i]))
+                   + (diff != (int32_t)((uint32_t)a[i] - (uint32_t)b[i]));
+        mismatch += (fix32::add<overflow::saturate>(a[i], b[i]) != sum)
+                  + (fix32::sub<overflow::saturate>(a[i], b[i]) != diff)
+                  + (fix32::add<overflow::check>(a[i], b[i]) != sum)
+                  + (fix32::sub<overflow::check>(a[i], b[i]) != diff);
+    }
+    return mismatch + (overflow_calls != overflows);
+}
+
+
+/**
+ * 'fix32::fixed<>' arithmetic, conversions and library functions against the
+ * C functions with the equivalent shift amounts
+ */
+double fix32check_cpp_fixed(const int32_t *a, const int32_t *b,
+                            size_t count)
+{
+    typedef fix32::fixed<2, 30> q30;
+    typedef fix32::fixed<16, 16> q16;
+    typedef fix32::fixed<18, 14> q14;
+    typedef fix32::fixed<16, 16, FIX32_RHD> q16_rhd;
+    double mismatch = 0.;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        q30 x = q30::from_raw(a[i]), y = q30::from_raw(b[i]);
+        q16 z = q16::from_raw(b[i]);
+
+        q14 p = x * z;
+        q16 r = fix32::mul<q16>(x, z);
+        q16_rhd s = q16_rhd(x);
+        q30 w = x;
+        w *= y;
+        mismatch += (p.raw() != fix32_mul_rhaz(a[i], b[i], 32))
+                  + (r.raw() != fix32_mul_rhaz(a[i], b[i], 30))
+                  + (s.raw() != fix32_scale_rhd_32(a[i], 14))
+                  + (w.raw() != fix32_mul_rhaz(a[i], b[i], 30))
+                  + ((x + y).raw() != (int32_t)((uint32_t)a[i] + b[i]))
+                  + ((x - y).raw() != (int32_t)((uint32_t)a[i] - b[i]))
+                  + ((x < y) != (a[i] < b[i]));
+
+        mismatch += fix32::atan2(x, y).raw() != fix32_atan2(a[i], b[i], 30);
+        if (a[i] > 0) {
+            // the inverse square root of values in (0, 2) is above 0.7
+            int scale = 30;
+            uint32_t inv = fix32_invsqrt((uint32_t)a[i], &scale);
+            q30 res = fix32::invsqrt<q30>(x);
+            mismatch += res.raw() != (int32_t)((scale > 30)
+                ? fix32_scale_rhaz_64(inv, scale - 30)
+                : (int64_t)inv << (30 - scale));
+        }
+    }
+    return mismatch;
+}
+
+
+/**
+ * Table computed by the compiler with the constexpr variants (the example of
+ * 'fix32constexpr.hpp'), including values of all magnitudes
+ */
+struct check_table {
+    int32_t invsqrt[64];
+    int invsqrt_scale[64];
+    int32_t atan2[64], sin[64], cos[64], mul[64];
+};
+
+static constexpr check_table check_make_table()
+{
+    check_table t = {};
+    for (int i = 0; i < 64; i++) {
+        uint32_t val = (0x9E3779B9u * (uint32_t)(i + 1)) >> (i % 32);
+        int32_t sval = (int32_t)(0x7F4A7C15u * (uint32_t)(i + 1)) >> (i % 31);
+        fix32::cx::invsqrt_result r = fix32::cx::invsqrt(val | 1, i % 32);
+        fix32::cx::sincos_result sc = fix32::cx::sincos(sval >> 3);
+        t.invsqrt[i] = (int32_t)r.val;
+        t.invsqrt_scale[i] = r.scale;
+        t.atan2[i] = fix32::cx::atan2(sval, (int32_t)val, 0);
+        t.sin[i] = sc.sin_val;
+        t.cos[i] = sc.cos_val;
+        t.mul[i] = fix32::cx::mul(sval, (int32_t)val, i % 32 + 1, FIX32_RHAZ);
+    }
+    return t;
+}
+
+static constexpr check_table check_tab = check_make_table();
+
+double fix32check_cpp_constexpr(void)
+{
+    double mismatch = 0.;
+    for (int i = 0; i < 64; i++) {
+        uint32_t val = (0x9E3779B9u * (uint32_t)(i + 1)) >> (i % 32);
+        int32_t sval = (int32_t)(0x7F4A7C15u * (uint32_t)(i + 1)) >> (i % 31);
+        int scale = i % 32;
+        int32_t s, c;
+        uint32_t inv = fix32_invsqrt(val | 1, &scale);
+        fix32_sincos(sval >> 3, &s, &c);
+        mismatch += (check_tab.invsqrt[i] != (int32_t)inv)
+                  + (check_tab.invsqrt_scale[i] != scale)
+                  + (check_tab.atan2[i] != fix32_atan2(sval, (int32_t)val, 0))
+                  + (check_tab.sin[i] != s) + (check_tab.cos[i] != c)
+                  + (check_tab.mul[i] != fix32_mul_rhaz(sval, (int32_t)val,
+                                                        i % 32 + 1));
+    }
+    return mismatch;
+}
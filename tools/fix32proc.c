@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Streaming processor for binary sample files using libfix32math
+ *
+ * Applies a kernel of the library to a file of raw native-endian 32-bit
+ * samples and writes the results to another file.  Both files are memory
+ * mapped; the input is processed by the thread pool of 'fix32par.h' in chunks
+ * of a cache-sized number of bytes.  The elapsed time and the
+ * throughput are reported on stderr, thus the tool doubles as an end-to-end
+ * benchmark of the library.  Runs on the build host (POSIX).
+ *
+ * Operations (I/Q files hold interleaved pairs of real and imaginary part):
+ *   atan2    phase of each I/Q sample with a scaling factor of 2^28
+ *   mag      magnitude of each I/Q sample (same scaling factor as the input)
+ *   norm     I/Q samples normalized to unit magnitude (scaling factor 2^30)
+ *   invsqrt  inverse square root of each unsigned sample with a scaling
+ *            factor of 2^scale, written with a scaling factor of 2^res_scale
+ *
+ * Usage: fix32proc [-t threads] [-c chunk_kib] [-s scale] [-r res_scale]
+ *                  <operation> <input> <output>
+ *
+ * By default, one thread per online processor and chunks of 256 KiB are used.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fix32math.h"
+#include "fix32cmplx.h"
+#include "fix32par.h"
+#include "fix32vec.h"
+
+
+typedef struct proc_args {
+    int scale, res_scale;
+} proc_args;
+
+typedef struct proc_op {
+    const char *name;
+    size_t in_size, out_size;   // bytes per input and output element
+    void (*run)(const void *src, void *dst, size_t count,
+                const proc_args *args);
+} proc_op;
+
+static void proc_atan2(const void *src, void *dst, size_t count,
+                       const proc_args *args)
+{
+    (void)args;
+    fix32_cmplx_phase_array(src, dst, count);
+}
+
+static void proc_mag(const void *src, void *dst, size_t count,
+                     const proc_args *args)
+{
+    (void)args;
+    fix32_cmplx_mag_array(src, dst, count);
+}
+
+static void proc_norm(const void *src, void *dst, size_t count,
+                      const proc_args *args)
+{
+    (void)args;
+    fix32_vec2_normalize(src, dst, count);
+}
+
+static void proc_invsqrt(const void *src, void *dst, size_t count,
+                         const proc_args *args)
+{
+    fix32_invsqrt_array(src, dst, count, args->scale, args->res_scale);
+}
+
+static const proc_op proc_ops[] = {
+    { "atan2",   8, 4, proc_atan2   },
+    { "mag",     8, 4, proc_mag     },
+    { "norm",    8, 8, proc_norm    },
+    { "invsqrt", 4, 4, proc_invsqrt },
+};
+
+
+// batch processed by the thread pool
+typedef struct proc_work {
+    const proc_op *op;
+    proc_args args;
+    const unsigned char *src;
+    unsigned char *dst;
+} proc_work;
+
+static void proc_kernel(size_t beg, size_t end, void *ctx)
+{
+    const proc_work *work = ctx;
+    const proc_op *op = work->op;
+    op->run(work->src + beg * op->in_size, work->dst + beg * op->out_size,
+            end - beg, &work->args);
+}
+
+
+static int usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-t threads] [-c chunk_kib] [-s scale] "
+            "[-r res_scale] <operation> <input> <output>\n"
+            "operations: atan2, mag, norm (I/Q input), invsqrt\n", prog);
+    return 1;
+}
+
+static double proc_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char *argv[])
+{
+    long threads = 0;
+    long chunk_kib = 256;
+    proc_args args = { 0, 0 };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:c:s:r:")) != -1) {
+        switch (opt) {
+            case 't':
+                threads = atol(optarg);
+                break;
+            case 'c':
+                chunk_kib = atol(optarg);
+                break;
+            case 's':
+                args.scale = atoi(optarg);
+                break;
+            case 'r':
+                args.res_scale = atoi(optarg);
+                break;
+            default:
+                return usage(argv[0]);
+        }
+    }
+    if (argc - optind != 3 || threads < 0 || chunk_kib < 1)
+        return usage(argv[0]);
+
+    const proc_op *op = NULL;
+    size_t i;
+    for (i = 0; i < sizeof(proc_ops) / sizeof(proc_ops[0]); i++)
+        if (strcmp(argv[optind], proc_ops[i].name) == 0)
+            op = &proc_ops[i];
+    if (op == NULL) {
+        fprintf(stderr, "%s: unknown operation '%s'\n", argv[0],
+                argv[optind]);
+        return usage(argv[0]);
+    }
+    const char *in_path = argv[optind + 1], *out_path = argv[optind + 2];
+
+    // map the input file
+    int in_fd = open(in_path, O_RDONLY);
+    struct stat st;
+    if (in_fd < 0 || fstat(in_fd, &st) != 0) {
+        fprintf(stderr, "%s: %s: %s\n", argv[0], in_path, strerror(errno));
+        return 1;
+    }
+    size_t count = (size_t)st.st_size / op->in_size;
+    if ((size_t)st.st_size % op->in_size)
+        fprintf(stderr, "%s: ignoring %zu trailing bytes of %s\n", argv[0],
+                (size_t)st.st_size % op->in_size, in_path);
+    if (count == 0) {
+        fprintf(stderr, "%s: %s: no samples\n", argv[0], in_path);
+        return 1;
+    }
+    void *src = mmap(NULL, count * op->in_size, PROT_READ, MAP_SHARED, in_fd,
+                     0);
+    if (src == MAP_FAILED) {
+        fprintf(stderr, "%s: %s: %s\n", argv[0], in_path, strerror(errno));
+        return 1;
+    }
+    posix_madvise(src, count * op->in_size, POSIX_MADV_SEQUENTIAL);
+
+    // create and map the output file
+    int out_fd = open(out_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0 || ftruncate(out_fd, (off_t)(count * op->out_size)) != 0) {
+        fprintf(stderr, "%s: %s: %s\n", argv[0], out_path, strerror(errno));
+        return 1;
+    }
+    void *dst = mmap(NULL, count * op->out_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, out_fd, 0);
+    if (dst == MAP_FAILED) {
+        fprintf(stderr, "%s: %s: %s\n", argv[0], out_path, strerror(errno));
+        return 1;
+    }
+
+    int res = fix32_par_init((unsigned)threads);
+    if (res < 0) {
+        fprintf(stderr, "%s: cannot create threads\n", argv[0]);
+        return 1;
+    }
+
+    proc_work work;
+    work.op   = op;
+    work.args = args;
+    work.src  = src;
+    work.dst  = dst;
+    size_t chunk = (size_t)chunk_kib * 1024 / op->in_size;
+
+    double start = proc_time();
+    fix32_par_for(count, (chunk > 0) ? chunk : 1, proc_kernel, &work);
+    double elapsed = proc_time() - start;
+    fix32_par_shutdown();
+
+    munmap(dst, count * op->out_size);
+    munmap(src, count * op->in_size);
+    close(out_fd);
+    close(in_fd);
+
+    double in_bytes = (double)count * op->in_size,
+           io_bytes = in_bytes + (double)count * op->out_size;
+    fprintf(stderr, "%s: %zu elements in %.3f s, %.2f GB/s input, "
+            "%.2f GB/s input + output (%d threads)\n", op->name, count,
+            elapsed, in_bytes / elapsed * 1e-9, io_bytes / elapsed * 1e-9,
+            res);
+    return 0;
+}
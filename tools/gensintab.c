@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020 Michael Platzer (TU Wien)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/**
+ * Sine table generator for libfix32math
+ *
+ * Prints a C header with a quarter-wave sine table of a full turn divided into
+ * 2^bits steps, i.e. the values sin(2 pi k / 2^bits) for 0 <= k <= 2^bits / 4
+ * with a scaling factor of 2^30, followed by one more entry for k = 2^bits / 4
+ * + 1 that allows interpolating between the last two entries of the quarter
+ * without a special case.  Runs on the build host.
+ *
+ * Usage: gensintab <bits>
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <bits>\n", argv[0]);
+        return 1;
+    }
+
+    int bits = atoi(argv[1]);
+    if (bits < 2 || bits > 24) {
+        fprintf(stderr, "%s: bits must be in the range 2 to 24\n", argv[0]);
+        return 1;
+    }
+
+    long quarter = 1L << (bits - 2);
+    const double pi = 3.14159265358979323846;
+
+    printf("// Generated by tools/gensintab.c; do not edit.\n\n");
+    printf("#define FIX32_SINTAB_BITS %d\n\n", bits);
+    printf("// sin(2 pi k / 2^%d) for 0 <= k <= 2^%d + 1 with a scaling "
+           "factor of 2^30\n", bits, bits - 2);
+    printf("static const int32_t fix32_sintab[%ld] = {", quarter + 2);
+
+    long k;
+    for (k = 0; k <= quarter + 1; k++) {
+        double val = sin(2. * pi * k / (4. * quarter)) * (1L << 30);
+        printf("%s%s%ld", (k == 0) ? "" : ",", (k % 6 == 0) ? "\n   " : " ",
+               (long)floor(val + 0.5));
+    }
+    printf("\n};\n");
+    return 0;
+}